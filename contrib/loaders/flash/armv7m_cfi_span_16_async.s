@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/***************************************************************************
+ *   Copyright (C) 2005, 2007 by Dominic Rath                              *
+ *   Dominic.Rath@gmx.de                                                   *
+ *   Copyright (C) 2010 Spencer Oliver                                     *
+ *   spen@spen-soft.co.uk                                                  *
+ ***************************************************************************/
+
+	.text
+	.syntax unified
+	.arch armv7-m
+	.thumb
+	.thumb_func
+
+	.align 2
+
+/* Asynchronous variant of armv7m_cfi_span_16.s, fed through the working */
+/* area FIFO by target_run_flash_async_algorithm(). */
+
+/* input parameters - */
+/*	R0 = workarea start */
+/*	R1 = workarea end */
+/*	R2 = destination address */
+/*	R3 = number of writes */
+/*	R4 = flash write command */
+/*	R5 = constant to mask DQ7 bits */
+/*	LR = constant to mask DQ5 bits, 0 to poll DQ7 only */
+/* output parameters - */
+/*	R2 = address of the failing write, rp = 0 on error */
+/* temp registers - */
+/*	R6 = value to write */
+/*	R7 = rp */
+/*	R12 = wp, value read from flash to test status */
+/* unlock registers - */
+/*  R8 = unlock1_addr */
+/*  R9 = unlock1_cmd */
+/*  R10 = unlock2_addr */
+/*  R11 = unlock2_cmd */
+
+wait_fifo:
+	ldr		r12, [r0, #0]	/* read wp */
+	cmp		r12, #0			/* abort if wp == 0 */
+	beq		done
+	ldr		r7, [r0, #4]	/* read rp */
+	cmp		r7, r12			/* wait until rp != wp */
+	beq		wait_fifo
+	ldrh	r6, [r7], #2
+	strh	r9, [r8]
+	strh	r11, [r10]
+	strh	r4, [r8]
+	strh	r6, [r2]
+busy:
+	ldrh	r12, [r2]
+	eor		r12, r12, r6
+	tst		r12, r5
+	beq		cont			/* b if DQ7 == Data7 */
+	ldrh	r12, [r2]
+	tst		r12, lr
+	beq		busy			/* b if DQ5 low */
+	ldrh	r12, [r2]
+	eor		r12, r12, r6
+	tst		r12, r5
+	beq		cont			/* b if DQ7 == Data7 */
+	movs	r7, #0			/* set rp = 0 on error */
+	str		r7, [r0, #4]
+	b		done
+cont:
+	cmp		r7, r1			/* wrap rp at end of buffer */
+	it		cs
+	addcs	r7, r0, #8
+	str		r7, [r0, #4]	/* store rp */
+	add		r2, r2, #2		/* 0x2 */
+	subs	r3, r3, #1		/* 0x1 */
+	bne		wait_fifo
+
+done:
+	bkpt #0
+
+	.end
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+	/* Runs a list of FTFx commands back to back.
+	 *
+	 * Each 16 byte record holds the 12 FCCOB bytes in FCCOB3..FCCOB8
+	 * register order followed by a word receiving FSTAT once the command
+	 * completes. The list stops at the first command reporting ACCERR,
+	 * FPVIOL or RDCOLERR; results of the records not run stay untouched.
+	 *
+	 * Params:
+	 * r0 = FTFx base
+	 * r1 = record list address
+	 * r2 = record count
+	 */
+
+	.text
+	.cpu cortex-m0plus
+	.code 16
+	.thumb_func
+
+	.align	2
+
+	/* r3 = tmp
+	 * r4 = tmp
+	 */
+
+FTFx_FSTAT =	0
+FTFx_FCCOB3 =	4
+FTFx_FCCOB7 =	8
+FTFx_FCCOBB =	12
+
+next_cmd:
+	ldr	r3, [r1, #0]
+	str	r3, [r0, #FTFx_FCCOB3]
+	ldr	r3, [r1, #4]
+	str	r3, [r0, #FTFx_FCCOB7]
+	ldr	r3, [r1, #8]
+	str	r3, [r0, #FTFx_FCCOBB]
+	movs	r3, #0x80
+	strb	r3, [r0, #FTFx_FSTAT]	/* launch */
+wait_ccif:
+	ldrb	r3, [r0, #FTFx_FSTAT]
+	lsls	r4, r3, #24		/* CCIF to N flag */
+	bpl	wait_ccif
+	str	r3, [r1, #12]		/* store FSTAT */
+	movs	r4, #0x70		/* ACCERR | FPVIOL | RDCOLERR */
+	tst	r3, r4
+	bne	done
+	adds	r1, #16
+	subs	r2, #1
+	bne	next_cmd
+done:
+	bkpt	#0
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+"""
+Compare the plain 0x1a terminated Tcl RPC protocol with the framed one
+(see 'tcl_framed' in the manual) by issuing the same command many times.
+
+Usage: ocd_rpc_framed_bench.py [count] [command]
+"""
+
+import socket
+import struct
+import sys
+import time
+
+TOKEN = b"\x1a"
+
+
+class PlainClient:
+    def __init__(self, sock):
+        self.sock = sock
+        self.pending = b""
+
+    def send(self, cmd):
+        self.sock.sendall(cmd.encode("utf-8") + TOKEN)
+        while TOKEN not in self.pending:
+            self.pending += self.sock.recv(65536)
+        reply, self.pending = self.pending.split(TOKEN, 1)
+        return reply
+
+
+class FramedClient:
+    def __init__(self, sock):
+        self.sock = sock
+        self.pending = b""
+        self.next_id = 1
+
+    def _read(self, size):
+        while len(self.pending) < size:
+            self.pending += self.sock.recv(65536)
+        data, self.pending = self.pending[:size], self.pending[size:]
+        return data
+
+    def request(self, cmd):
+        req_id = self.next_id
+        self.next_id += 1
+        payload = cmd.encode("utf-8")
+        self.sock.sendall(struct.pack("<II", len(payload), req_id) + payload)
+        return req_id
+
+    def reply(self):
+        """Return (id, status, data), skipping notification frames."""
+        while True:
+            length, req_id, status = struct.unpack("<IIi", self._read(12))
+            data = self._read(length)
+            if req_id != 0:
+                return req_id, status, data
+
+    def pipeline(self, cmds, window=64):
+        results = []
+        sent = 0
+        while len(results) < len(cmds):
+            while sent < len(cmds) and sent - len(results) < window:
+                self.request(cmds[sent])
+                sent += 1
+            results.append(self.reply())
+        return results
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 10000
+    command = sys.argv[2] if len(sys.argv) > 2 else "mdw 0x20000000"
+
+    sock = socket.create_connection(("127.0.0.1", 6666))
+    plain = PlainClient(sock)
+
+    start = time.monotonic()
+    for _ in range(count):
+        plain.send(command)
+    plain_time = time.monotonic() - start
+
+    plain.send("tcl_framed on")
+    framed = FramedClient(sock)
+
+    start = time.monotonic()
+    results = framed.pipeline([command] * count)
+    framed_time = time.monotonic() - start
+
+    errors = sum(1 for _, status, _ in results if status != 0)
+    framed.request("tcl_framed off")
+    framed.reply()
+    sock.sendall(b"exit" + TOKEN)
+    sock.close()
+
+    print("%d x '%s'" % (count, command))
+    print("plain:  %.3f s (%.0f req/s)" % (plain_time, count / plain_time))
+    print("framed: %.3f s (%.0f req/s), %d errors" % (framed_time, count / framed_time, errors))
+
+
+if __name__ == "__main__":
+    main()
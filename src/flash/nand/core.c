@@ -293,6 +293,10 @@ int nand_probe(struct nand_device *nand)
 	uint8_t manufacturer_id, device_id;
 	uint8_t id_buff[6] = { 0 };	/* zero buff to silence false warning
 					 * from clang static analyzer */
+	struct nand_info *prev_device = nand->device;
+	int prev_mfr_id = nand->manufacturer ? nand->manufacturer->id : -1;
+	int prev_erase_size = nand->erase_size;
+	int num_blocks;
 	int retval;
 	int i;
 
@@ -486,8 +490,29 @@ int nand_probe(struct nand_device *nand)
 		}
 	}
 
-	nand->num_blocks = (nand->device->chip_size * 1024) / (nand->erase_size / 1024);
+	num_blocks = (nand->device->chip_size * 1024) / (nand->erase_size / 1024);
+
+	/* Re-probing the same chip keeps the bad block table built so far,
+	 * saving a full OOB scan on the next erase; the erased state may
+	 * have been changed behind our back and is forgotten. */
+	if (nand->blocks && nand->device == prev_device
+			&& nand->manufacturer->id == prev_mfr_id
+			&& nand->erase_size == prev_erase_size
+			&& nand->num_blocks == num_blocks) {
+		LOG_DEBUG("same NAND device, keeping bad block table");
+		for (i = 0; i < nand->num_blocks; i++)
+			nand->blocks[i].is_erased = -1;
+		return ERROR_OK;
+	}
+
+	free(nand->blocks);
+	nand->num_blocks = num_blocks;
 	nand->blocks = malloc(sizeof(struct nand_block) * nand->num_blocks);
+	if (!nand->blocks) {
+		LOG_ERROR("Out of memory");
+		nand->num_blocks = 0;
+		return ERROR_FAIL;
+	}
 
 	for (i = 0; i < nand->num_blocks; i++) {
 		nand->blocks[i].size = nand->erase_size;
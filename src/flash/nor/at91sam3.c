@@ -3143,17 +3143,41 @@ static int _sam3_probe(struct flash_bank *bank, int noise)
 		return ERROR_FAIL;
 	}
 
-	r = sam3_read_all_regs(private->chip);
-	if (r != ERROR_OK)
-		return r;
+	/* The chip description is shared by all banks of the chip. Once it
+	 * is known, re-reading CHIPID_CIDR is enough to confirm the part
+	 * has not changed; otherwise identify it from scratch. */
+	if (private->chip->probed) {
+		uint32_t cidr;
 
-	LOG_DEBUG("Here");
-	if (private->chip->probed)
-		r = sam3_get_info(private->chip);
-	else
+		r = target_read_u32(bank->target, SAM3_CHIPID_CIDR, &cidr);
+		if (r != ERROR_OK)
+			return r;
+
+		/* SAM3X/SAM3A: same fallback as in sam3_read_all_regs() */
+		if (cidr == 0) {
+			r = target_read_u32(bank->target, SAM3_CHIPID_CIDR2, &cidr);
+			if (r != ERROR_OK)
+				return r;
+		}
+
+		if (private->chip->cfg.CHIPID_CIDR != cidr) {
+			LOG_INFO("SAM3 CHIPID_CIDR changed, identifying the chip again");
+			private->chip->probed = false;
+		}
+	}
+
+	if (!private->chip->probed) {
+		r = sam3_read_all_regs(private->chip);
+		if (r != ERROR_OK)
+			return r;
+
+		LOG_DEBUG("Here");
 		r = sam3_get_details(private);
-	if (r != ERROR_OK)
-		return r;
+		if (r != ERROR_OK)
+			return r;
+
+		private->chip->probed = true;
+	}
 
 	/* update the flash bank size */
 	for (unsigned int x = 0; x < SAM3_MAX_FLASH_BANKS; x++) {
@@ -2649,17 +2649,34 @@ static int sam4_probe(struct flash_bank *bank)
 		return ERROR_FAIL;
 	}
 
-	r = sam4_read_all_regs(private->chip);
-	if (r != ERROR_OK)
-		return r;
+	/* The chip description is shared by all banks of the chip. Once it
+	 * is known, re-reading CHIPID_CIDR is enough to confirm the part
+	 * has not changed; otherwise identify it from scratch. */
+	if (private->chip->probed) {
+		uint32_t cidr = private->chip->cfg.CHIPID_CIDR;
 
-	LOG_DEBUG("Here");
-	if (private->chip->probed)
-		r = sam4_get_info(private->chip);
-	else
+		r = sam4_read_this_reg(private->chip, &(private->chip->cfg.CHIPID_CIDR));
+		if (r != ERROR_OK)
+			return r;
+
+		if (private->chip->cfg.CHIPID_CIDR != cidr) {
+			LOG_INFO("SAM4 CHIPID_CIDR changed, identifying the chip again");
+			private->chip->probed = false;
+		}
+	}
+
+	if (!private->chip->probed) {
+		r = sam4_read_all_regs(private->chip);
+		if (r != ERROR_OK)
+			return r;
+
+		LOG_DEBUG("Here");
 		r = sam4_get_details(private);
-	if (r != ERROR_OK)
-		return r;
+		if (r != ERROR_OK)
+			return r;
+
+		private->chip->probed = true;
+	}
 
 	/* update the flash bank size */
 	for (unsigned int x = 0; x < SAM4_MAX_FLASH_BANKS; x++) {
@@ -1574,6 +1574,127 @@ static int cfi_spansion_write_block_mips(struct flash_bank *bank, const uint8_t
 	return retval;
 }
 
+static int cfi_spansion_write_block_async(struct flash_bank *bank, const uint8_t *buffer,
+	uint32_t address, uint32_t count)
+{
+	struct cfi_flash_bank *cfi_info = bank->driver_priv;
+	struct cfi_spansion_pri_ext *pri_ext = cfi_info->pri_ext;
+	struct target *target = bank->target;
+	struct reg_param reg_params[11];
+	struct armv7m_algorithm armv7m_algo;
+	struct working_area *write_algorithm;
+	struct working_area *source;
+	uint32_t buffer_size;
+	uint32_t wcount = count / bank->bus_width;
+	int retval;
+
+	/* see contrib/loaders/flash/armv7m_cfi_span_16_async.s for src */
+	static const uint32_t armv7m_word_16_async_code[] = {
+		0xC000F8D0,
+		0x0F00F1BC,
+		0x6847D02A,
+		0xD0F74567,
+		0x6B02F837,
+		0x9000F8A8,
+		0xB000F8AA,
+		0x4000F8A8,
+		0xF8B28016,
+		0xEA8CC000,
+		0xEA1C0C06,
+		0xD00E0F05,
+		0xC000F8B2,
+		0x0F0EEA1C,
+		0xF8B2D0F3,
+		0xEA8CC000,
+		0xEA1C0C06,
+		0xD0020F05,
+		0x60472700,
+		0x428FE008,
+		0xF100BF28,
+		0x60470708,
+		0x0202F102,
+		0xD1CF1E5B,
+		0x0000BE00
+	};
+	uint8_t target_code[sizeof(armv7m_word_16_async_code)];
+
+	target_buffer_set_u32_array(target, target_code,
+			ARRAY_SIZE(armv7m_word_16_async_code), armv7m_word_16_async_code);
+
+	if (target_alloc_working_area(target, sizeof(target_code),
+			&write_algorithm) != ERROR_OK) {
+		LOG_WARNING("no working area available, can't do block memory writes");
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+	}
+
+	retval = target_write_buffer(target, write_algorithm->address,
+			sizeof(target_code), target_code);
+	if (retval != ERROR_OK) {
+		target_free_working_area(target, write_algorithm);
+		return retval;
+	}
+
+	/* FIFO: take what is left of the working area, but never more than
+	 * the data plus the rp/wp header; below 256 bytes the synchronous
+	 * algorithm is just as fast */
+	buffer_size = target_get_working_area_avail(target);
+	buffer_size = MIN(count + 8, MAX(buffer_size, 256));
+
+	retval = target_alloc_working_area(target, buffer_size, &source);
+	if (retval != ERROR_OK) {
+		target_free_working_area(target, write_algorithm);
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+	}
+
+	init_reg_param(&reg_params[0], "r0", 32, PARAM_OUT);	/* workarea start */
+	init_reg_param(&reg_params[1], "r1", 32, PARAM_OUT);	/* workarea end */
+	init_reg_param(&reg_params[2], "r2", 32, PARAM_IN_OUT);	/* flash address */
+	init_reg_param(&reg_params[3], "r3", 32, PARAM_OUT);	/* number of writes */
+	init_reg_param(&reg_params[4], "r4", 32, PARAM_OUT);	/* write command */
+	init_reg_param(&reg_params[5], "r5", 32, PARAM_OUT);	/* DQ7 mask */
+	init_reg_param(&reg_params[6], "lr", 32, PARAM_OUT);	/* DQ5 mask */
+	init_reg_param(&reg_params[7], "r8", 32, PARAM_OUT);
+	init_reg_param(&reg_params[8], "r9", 32, PARAM_OUT);
+	init_reg_param(&reg_params[9], "r10", 32, PARAM_OUT);
+	init_reg_param(&reg_params[10], "r11", 32, PARAM_OUT);
+
+	buf_set_u32(reg_params[0].value, 0, 32, source->address);
+	buf_set_u32(reg_params[1].value, 0, 32, source->address + source->size);
+	buf_set_u32(reg_params[2].value, 0, 32, address);
+	buf_set_u32(reg_params[3].value, 0, 32, wcount);
+	buf_set_u32(reg_params[4].value, 0, 32, cfi_command_val(bank, 0xA0));
+	buf_set_u32(reg_params[5].value, 0, 32, cfi_command_val(bank, 0x80));
+	/* without DQ5 support poll DQ7 DATA# only */
+	buf_set_u32(reg_params[6].value, 0, 32,
+			(cfi_info->status_poll_mask & (1 << 5)) ? cfi_command_val(bank, 0x20) : 0);
+	buf_set_u32(reg_params[7].value, 0, 32, cfi_flash_address(bank, 0, pri_ext->_unlock1));
+	buf_set_u32(reg_params[8].value, 0, 32, 0xaaaaaaaa);
+	buf_set_u32(reg_params[9].value, 0, 32, cfi_flash_address(bank, 0, pri_ext->_unlock2));
+	buf_set_u32(reg_params[10].value, 0, 32, 0x55555555);
+
+	armv7m_algo.common_magic = ARMV7M_COMMON_MAGIC;
+	armv7m_algo.core_mode = ARM_MODE_THREAD;
+
+	retval = target_run_flash_async_algorithm(target, buffer, wcount, bank->bus_width,
+			0, NULL,
+			ARRAY_SIZE(reg_params), reg_params,
+			source->address, source->size,
+			write_algorithm->address, 0,
+			&armv7m_algo);
+
+	if (retval == ERROR_FLASH_OPERATION_FAILED)
+		LOG_ERROR("flash write block failed at address 0x%" PRIx32,
+				buf_get_u32(reg_params[2].value, 0, 32));
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(reg_params); i++)
+		destroy_reg_param(&reg_params[i]);
+
+	target_free_working_area(target, source);
+	target_free_working_area(target, write_algorithm);
+
+	return retval;
+}
+
 static int cfi_spansion_write_block(struct flash_bank *bank, const uint8_t *buffer,
 	uint32_t address, uint32_t count)
 {
@@ -1781,6 +1902,15 @@ static int cfi_spansion_write_block(struct flash_bank *bank, const uint8_t *buff
 	if (strncmp(target_type_name(target), "mips_m4k", 8) == 0)
 		return cfi_spansion_write_block_mips(bank, buffer, address, count);
 
+	/* Cortex-M can keep programming while the host refills the FIFO */
+	if (is_armv7m(target_to_armv7m(target)) && bank->bus_width == 2) {
+		retval = cfi_spansion_write_block_async(bank, buffer, address, count);
+		if (retval != ERROR_TARGET_RESOURCE_NOT_AVAILABLE)
+			return retval;
+		LOG_DEBUG("no FIFO working area, falling back to synchronous block writes");
+		retval = ERROR_OK;
+	}
+
 	if (is_armv7m(target_to_armv7m(target))) {	/* armv7m target */
 		armv7m_algo.common_magic = ARMV7M_COMMON_MAGIC;
 		armv7m_algo.core_mode = ARM_MODE_THREAD;
@@ -333,7 +333,7 @@ int get_flash_bank_by_addr(struct target *target,
 static int default_flash_mem_blank_check(struct flash_bank *bank)
 {
 	struct target *target = bank->target;
-	const int buffer_size = 1024;
+	const int buffer_size = 16384;
 	uint32_t n_bytes;
 	int retval = ERROR_OK;
 
@@ -343,12 +343,17 @@ static int default_flash_mem_blank_check(struct flash_bank *bank)
 	}
 
 	uint8_t *buffer = malloc(buffer_size);
+	if (!buffer) {
+		LOG_ERROR("Out of memory");
+		return ERROR_FAIL;
+	}
 
 	for (unsigned int i = 0; i < bank->num_sectors; i++) {
 		uint32_t j;
 		bank->sectors[i].is_erased = 1;
 
-		for (j = 0; j < bank->sectors[i].size; j += buffer_size) {
+		/* one non-erased byte settles the sector, skip the rest of it */
+		for (j = 0; j < bank->sectors[i].size && bank->sectors[i].is_erased; j += buffer_size) {
 			uint32_t chunk;
 			chunk = buffer_size;
 			if (chunk > (bank->sectors[i].size - j))
@@ -377,32 +382,47 @@ done:
 	return retval;
 }
 
-int default_flash_blank_check(struct flash_bank *bank)
+int default_flash_blank_check_banks(struct flash_bank **banks, unsigned int num_banks)
 {
-	struct target *target = bank->target;
+	struct target *target = banks[0]->target;
+	uint8_t erased_value = banks[0]->erased_value;
+	unsigned int num_sectors = 0;
 	int retval;
 
-	if (bank->target->state != TARGET_HALTED) {
+	for (unsigned int b = 0; b < num_banks; b++) {
+		if (banks[b]->target != target || banks[b]->erased_value != erased_value) {
+			LOG_ERROR("BUG: banks checked together must share target and erased value");
+			return ERROR_FAIL;
+		}
+		num_sectors += banks[b]->num_sectors;
+	}
+
+	if (target->state != TARGET_HALTED) {
 		LOG_ERROR("Target not halted");
 		return ERROR_TARGET_NOT_HALTED;
 	}
 
 	struct target_memory_check_block *block_array;
-	block_array = malloc(bank->num_sectors * sizeof(struct target_memory_check_block));
+	block_array = malloc(num_sectors * sizeof(struct target_memory_check_block));
 	if (!block_array)
-		return default_flash_mem_blank_check(bank);
-
-	for (unsigned int i = 0; i < bank->num_sectors; i++) {
-		block_array[i].address = bank->base + bank->sectors[i].offset;
-		block_array[i].size = bank->sectors[i].size;
-		block_array[i].result = UINT32_MAX; /* erase state unknown */
+		goto slow_check;
+
+	/* one block list spanning all banks, so that a single algorithm
+	 * run can cover e.g. both banks of a dual-bank device */
+	unsigned int n = 0;
+	for (unsigned int b = 0; b < num_banks; b++) {
+		for (unsigned int i = 0; i < banks[b]->num_sectors; i++, n++) {
+			block_array[n].address = banks[b]->base + banks[b]->sectors[i].offset;
+			block_array[n].size = banks[b]->sectors[i].size;
+			block_array[n].result = UINT32_MAX; /* erase state unknown */
+		}
 	}
 
 	bool fast_check = true;
-	for (unsigned int i = 0; i < bank->num_sectors; ) {
+	for (unsigned int i = 0; i < num_sectors; ) {
 		retval = target_blank_check_memory(target,
-				block_array + i, bank->num_sectors - i,
-				bank->erased_value);
+				block_array + i, num_sectors - i,
+				erased_value);
 		if (retval < 1) {
 			/* Run slow fallback if the first run gives no result
 			 * otherwise use possibly incomplete results */
@@ -414,20 +434,34 @@ int default_flash_blank_check(struct flash_bank *bank)
 	}
 
 	if (fast_check) {
-		for (unsigned int i = 0; i < bank->num_sectors; i++)
-			bank->sectors[i].is_erased = block_array[i].result;
-		retval = ERROR_OK;
-	} else {
-		if (retval == ERROR_NOT_IMPLEMENTED)
-			LOG_USER("Running slow fallback erase check");
-		else
-			LOG_USER("Running slow fallback erase check - add working memory");
-
-		retval = default_flash_mem_blank_check(bank);
+		n = 0;
+		for (unsigned int b = 0; b < num_banks; b++)
+			for (unsigned int i = 0; i < banks[b]->num_sectors; i++, n++)
+				banks[b]->sectors[i].is_erased = block_array[n].result;
+		free(block_array);
+		return ERROR_OK;
 	}
+
 	free(block_array);
 
-	return retval;
+	if (retval == ERROR_NOT_IMPLEMENTED)
+		LOG_USER("Running slow fallback erase check");
+	else
+		LOG_USER("Running slow fallback erase check - add working memory");
+
+slow_check:
+	for (unsigned int b = 0; b < num_banks; b++) {
+		retval = default_flash_mem_blank_check(banks[b]);
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	return ERROR_OK;
+}
+
+int default_flash_blank_check(struct flash_bank *bank)
+{
+	return default_flash_blank_check_banks(&bank, 1);
 }
 
 /* Manipulate given flash region, selecting the bank according to target
@@ -217,6 +217,16 @@ int default_flash_verify(struct flash_bank *bank,
  * @returns ERROR_OK if successful; otherwise, an error code.
  */
 int default_flash_blank_check(struct flash_bank *bank);
+
+/**
+ * Checks the erase state of several banks at once, handing all their
+ * sectors to a single target_blank_check_memory() invocation.
+ * @param banks Banks to check, all on the same target and with the same
+ * erased value.
+ * @param num_banks The number of entries in @a banks.
+ * @returns ERROR_OK if successful; otherwise, an error code.
+ */
+int default_flash_blank_check_banks(struct flash_bank **banks, unsigned int num_banks);
 /**
  * Returns the flash bank specified by @a name, which matches the
  * driver name and a suffix (option) specify the driver-specific
@@ -9,6 +9,7 @@
 #endif
 
 #include "imp.h"
+#include <jtag/adapter.h>
 #include <jtag/jtag.h>
 #include <flash/nor/spi.h>
 #include <helper/time_support.h>
@@ -16,6 +17,13 @@
 
 #define JTAGSPI_MAX_TIMEOUT 3000
 
+/* Page programs queued into one JTAG flush */
+#define JTAGSPI_BATCH_PAGES 64
+/* Initial delay after a queued page program, doubled when the flash
+ * turns out to be still busy */
+#define JTAGSPI_PAGE_PROG_US 500
+#define JTAGSPI_MAX_PAGE_PROG_US 8000
+
 
 struct jtagspi_flash_bank {
 	struct jtag_tap *tap;
@@ -27,6 +35,7 @@ struct jtagspi_flash_bank {
 	struct pld_device *pld_device; /* if not NULL, the PLD has special instructions for JTAGSPI */
 	uint32_t ir;                   /* when !pld_device, this instruction code is used in
 									  jtagspi_set_user_ir to connect through a proxy bitstream */
+	unsigned int page_prog_us;     /* delay after a page program in batched writes */
 };
 
 FLASH_BANK_COMMAND_HANDLER(jtagspi_flash_bank_command)
@@ -76,6 +85,7 @@ FLASH_BANK_COMMAND_HANDLER(jtagspi_flash_bank_command)
 
 	info->ir = ir;
 	info->pld_device = device;
+	info->page_prog_us = JTAGSPI_PAGE_PROG_US;
 
 	return ERROR_OK;
 }
@@ -99,7 +109,10 @@ static void flip_u8(const uint8_t *in, uint8_t *out, unsigned int len)
 		out[i] = flip_u32(in[i], 8);
 }
 
-static int jtagspi_cmd(struct flash_bank *bank, uint8_t cmd,
+/* Queue one SPI command without executing the JTAG queue. Write data is
+ * copied into the queue, read data is available bit-reversed in
+ * data_buffer after jtag_execute_queue() */
+static int jtagspi_queue_cmd(struct flash_bank *bank, uint8_t cmd,
 		uint8_t *write_buffer, unsigned int write_len, uint8_t *data_buffer, int data_len)
 {
 	assert(write_buffer || write_len == 0);
@@ -184,22 +197,42 @@ static int jtagspi_cmd(struct flash_bank *bank, uint8_t cmd,
 		n++;
 	}
 
+	if (!info->pld_device)
+		jtagspi_set_user_ir(info);
+
+	/* passing from an IR scan to SHIFT-DR clears BYPASS registers */
+	jtag_add_dr_scan(info->tap, n, fields, TAP_IDLE);
+
+	/* out values are copied to the queue, restore the caller's buffers */
+	flip_u8(write_buffer, write_buffer, write_len);
+	if (!is_read)
+		flip_u8(data_buffer, data_buffer, data_len);
+
+	return ERROR_OK;
+}
+
+static int jtagspi_cmd(struct flash_bank *bank, uint8_t cmd,
+		uint8_t *write_buffer, unsigned int write_len, uint8_t *data_buffer, int data_len)
+{
+	struct jtagspi_flash_bank *info = bank->driver_priv;
+
 	if (info->pld_device) {
 		int retval = pld_connect_spi_to_jtag(info->pld_device);
 		if (retval != ERROR_OK)
 			return retval;
-	} else {
-		jtagspi_set_user_ir(info);
 	}
 
-	/* passing from an IR scan to SHIFT-DR clears BYPASS registers */
-	jtag_add_dr_scan(info->tap, n, fields, TAP_IDLE);
-	int retval = jtag_execute_queue();
+	int retval = jtagspi_queue_cmd(bank, cmd, write_buffer, write_len, data_buffer, data_len);
 	if (retval != ERROR_OK)
 		return retval;
 
-	if (is_read)
-		flip_u8(data_buffer, data_buffer, data_len);
+	retval = jtag_execute_queue();
+	if (retval != ERROR_OK)
+		return retval;
+
+	/* negative data_len == read operation */
+	if (data_len < 0)
+		flip_u8(data_buffer, data_buffer, -data_len);
 
 	if (info->pld_device)
 		return pld_disconnect_spi_from_jtag(info->pld_device);
@@ -740,10 +773,116 @@ static int jtagspi_page_write(struct flash_bank *bank, const uint8_t *buffer, ui
 	return jtagspi_wait(bank, JTAGSPI_MAX_TIMEOUT);
 }
 
+/* Queue a delay of approx. us microseconds while the TAP stays in IDLE */
+static void jtagspi_queue_delay(unsigned int us)
+{
+	unsigned int khz = adapter_get_speed_khz();
+
+	if (khz)
+		jtag_add_runtest(DIV_ROUND_UP(us * khz, 1000), TAP_IDLE);
+	else
+		jtag_add_sleep(us);
+}
+
+/* Queue up to JTAGSPI_BATCH_PAGES page programs into a single JTAG flush.
+ * Each page is preceded by write enable and a status read, which tells
+ * after the flush whether the flash accepted the page program. Pages
+ * rejected because the previous one was still in progress are written
+ * again one by one. */
+static int jtagspi_write_batch(struct flash_bank *bank, const uint8_t *buffer,
+		uint32_t offset, uint32_t count, uint32_t pagesize, uint32_t *written)
+{
+	struct jtagspi_flash_bank *info = bank->driver_priv;
+	struct {
+		uint32_t offset;
+		uint32_t size;
+		uint8_t status;
+	} pages[JTAGSPI_BATCH_PAGES];
+	uint8_t addr[sizeof(uint32_t)];
+	unsigned int n = 0;
+	int retval;
+
+	/* ATXP032/064/128 use always 4-byte addresses except for 0x03 read */
+	unsigned int addr_len = ((info->dev.read_cmd != 0x03) && info->always_4byte) ? 4 : info->addr_len;
+
+	if (info->pld_device) {
+		retval = pld_connect_spi_to_jtag(info->pld_device);
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	*written = 0;
+	while (count > *written && n < JTAGSPI_BATCH_PAGES) {
+		uint32_t page_offset = offset + *written;
+		/* length up to end of current page */
+		uint32_t currsize = ((page_offset + pagesize) & ~(pagesize - 1)) - page_offset;
+		/* but no more than remaining size */
+		currsize = MIN(count - *written, currsize);
+
+		pages[n].offset = page_offset;
+		pages[n].size = currsize;
+
+		retval = jtagspi_queue_cmd(bank, SPIFLASH_WRITE_ENABLE, NULL, 0, NULL, 0);
+		if (retval == ERROR_OK)
+			retval = jtagspi_queue_cmd(bank, SPIFLASH_READ_STATUS, NULL, 0, &pages[n].status, -1);
+		if (retval == ERROR_OK)
+			retval = jtagspi_queue_cmd(bank, info->dev.pprog_cmd,
+					fill_addr(page_offset, addr_len, addr), addr_len,
+					(uint8_t *)buffer + *written, currsize);
+		if (retval != ERROR_OK)
+			return retval;
+
+		/* give the flash time to program before the next write enable */
+		jtagspi_queue_delay(info->page_prog_us);
+
+		*written += currsize;
+		n++;
+	}
+
+	retval = jtag_execute_queue();
+	if (retval != ERROR_OK)
+		return retval;
+
+	if (info->pld_device) {
+		retval = pld_disconnect_spi_from_jtag(info->pld_device);
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	retval = jtagspi_wait(bank, JTAGSPI_MAX_TIMEOUT);
+	if (retval != ERROR_OK)
+		return retval;
+
+	/* A page program was accepted iff write enable succeeded on an idle flash */
+	unsigned int rejected = 0;
+	for (unsigned int i = 0; i < n; i++) {
+		uint8_t status;
+		flip_u8(&pages[i].status, &status, 1);
+		if ((status & SPIFLASH_WE_BIT) && !(status & SPIFLASH_BSY_BIT))
+			continue;
+
+		LOG_DEBUG("page at 0x%08" PRIx32 " not accepted, status=0x%02" PRIx8,
+			pages[i].offset, status);
+		rejected++;
+		retval = jtagspi_page_write(bank, buffer + (pages[i].offset - offset),
+				pages[i].offset, pages[i].size);
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	if (rejected && info->page_prog_us < JTAGSPI_MAX_PAGE_PROG_US) {
+		info->page_prog_us = MIN(2 * info->page_prog_us, JTAGSPI_MAX_PAGE_PROG_US);
+		LOG_DEBUG("%u of %u pages rejected, page program delay now %u us",
+			rejected, n, info->page_prog_us);
+	}
+
+	return ERROR_OK;
+}
+
 static int jtagspi_write(struct flash_bank *bank, const uint8_t *buffer, uint32_t offset, uint32_t count)
 {
 	struct jtagspi_flash_bank *info = bank->driver_priv;
-	uint32_t pagesize, currsize;
+	uint32_t pagesize, written;
 	int retval;
 
 	if (!(info->probed)) {
@@ -755,20 +894,15 @@ static int jtagspi_write(struct flash_bank *bank, const uint8_t *buffer, uint32_
 	pagesize = info->dev.pagesize ? info->dev.pagesize : SPIFLASH_DEF_PAGESIZE;
 
 	while (count > 0) {
-		/* length up to end of current page */
-		currsize = ((offset + pagesize) & ~(pagesize - 1)) - offset;
-		/* but no more than remaining size */
-		currsize = (count < currsize) ? count : currsize;
-
-		retval = jtagspi_page_write(bank, buffer, offset, currsize);
+		retval = jtagspi_write_batch(bank, buffer, offset, count, pagesize, &written);
 		if (retval != ERROR_OK) {
 			LOG_ERROR("page write error");
 			return retval;
 		}
-		LOG_DEBUG("wrote page at 0x%08" PRIx32, offset);
-		offset += currsize;
-		buffer += currsize;
-		count -= currsize;
+		LOG_DEBUG("wrote 0x%08" PRIx32 " bytes at 0x%08" PRIx32, written, offset);
+		offset += written;
+		buffer += written;
+		count -= written;
 	}
 	return ERROR_OK;
 }
@@ -1516,18 +1516,39 @@ static int kinetis_fill_fcf(struct flash_bank *bank, uint8_t *fcf)
 	return ERROR_OK;
 }
 
+/* Lay out FCCOB bytes in FCCOB3..FCCOB8 register order, ready for three
+ * little endian word writes starting at FTFX_FCCOB3 */
+static void kinetis_ftfx_fill_fccob(uint8_t *command, uint8_t fcmd, uint32_t faddr,
+				uint8_t fccob4, uint8_t fccob5, uint8_t fccob6, uint8_t fccob7,
+				uint8_t fccob8, uint8_t fccob9, uint8_t fccoba, uint8_t fccobb)
+{
+	command[0] = faddr & 0xff;
+	command[1] = (faddr >> 8) & 0xff;
+	command[2] = (faddr >> 16) & 0xff;
+	command[3] = fcmd;
+	command[4] = fccob7;
+	command[5] = fccob6;
+	command[6] = fccob5;
+	command[7] = fccob4;
+	command[8] = fccobb;
+	command[9] = fccoba;
+	command[10] = fccob9;
+	command[11] = fccob8;
+}
+
 static int kinetis_ftfx_command(struct target *target, uint8_t fcmd, uint32_t faddr,
 				uint8_t fccob4, uint8_t fccob5, uint8_t fccob6, uint8_t fccob7,
 				uint8_t fccob8, uint8_t fccob9, uint8_t fccoba, uint8_t fccobb,
 				uint8_t *ftfx_fstat)
 {
-	uint8_t command[12] = {faddr & 0xff, (faddr >> 8) & 0xff, (faddr >> 16) & 0xff, fcmd,
-			fccob7, fccob6, fccob5, fccob4,
-			fccobb, fccoba, fccob9, fccob8};
+	uint8_t command[12];
 	int result;
 	uint8_t fstat;
 	int64_t ms_timeout = timeval_ms() + 250;
 
+	kinetis_ftfx_fill_fccob(command, fcmd, faddr, fccob4, fccob5, fccob6, fccob7,
+			fccob8, fccob9, fccoba, fccobb);
+
 	result = target_write_memory(target, FTFX_FCCOB3, 4, 3, command);
 	if (result != ERROR_OK)
 		return result;
@@ -1565,6 +1586,124 @@ static int kinetis_ftfx_command(struct target *target, uint8_t fcmd, uint32_t fa
 }
 
 
+#define KINETIS_FTFX_BATCH_RECORD	16
+
+/* Run FTFx commands back to back from a working area list, saving the
+ * host round trips of launching and polling each one.
+ * @a commands holds @a count 12 byte FCCOB images as laid out by
+ * kinetis_ftfx_fill_fccob(). @a ftfx_fstat receives FSTAT of every
+ * command; the list stops at the first ACCERR/FPVIOL/RDCOLERR and the
+ * commands not run report 0 (CCIF clear).
+ * Returns ERROR_TARGET_RESOURCE_NOT_AVAILABLE without working area, the
+ * caller then issues the commands one by one. */
+static int kinetis_ftfx_command_batch(struct target *target, const uint8_t *commands,
+				unsigned int count, uint8_t *ftfx_fstat)
+{
+	struct working_area *batch_algorithm;
+	struct working_area *records;
+	struct reg_param reg_params[3];
+	struct armv7m_algorithm armv7m_info;
+	int retval;
+
+	static const uint8_t kinetis_ftfx_batch_code[] = {
+#include "../../../contrib/loaders/flash/kinetis/kinetis_ftfx_batch.inc"
+	};
+
+	if (target_alloc_working_area_try(target, sizeof(kinetis_ftfx_batch_code),
+			&batch_algorithm) != ERROR_OK)
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+
+	retval = target_write_buffer(target, batch_algorithm->address,
+			sizeof(kinetis_ftfx_batch_code), kinetis_ftfx_batch_code);
+	if (retval != ERROR_OK) {
+		target_free_working_area(target, batch_algorithm);
+		return retval;
+	}
+
+	unsigned int chunk = target_get_working_area_avail(target) / KINETIS_FTFX_BATCH_RECORD;
+	chunk = MIN(chunk, count);
+	if (chunk == 0 || target_alloc_working_area_try(target,
+			chunk * KINETIS_FTFX_BATCH_RECORD, &records) != ERROR_OK) {
+		target_free_working_area(target, batch_algorithm);
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+	}
+
+	uint8_t *buf = malloc(chunk * KINETIS_FTFX_BATCH_RECORD);
+	if (!buf) {
+		LOG_ERROR("Out of memory");
+		target_free_working_area(target, records);
+		target_free_working_area(target, batch_algorithm);
+		return ERROR_FAIL;
+	}
+
+	armv7m_info.common_magic = ARMV7M_COMMON_MAGIC;
+	armv7m_info.core_mode = ARM_MODE_THREAD;
+
+	init_reg_param(&reg_params[0], "r0", 32, PARAM_OUT);	/* FTFx base */
+	init_reg_param(&reg_params[1], "r1", 32, PARAM_OUT);	/* record list */
+	init_reg_param(&reg_params[2], "r2", 32, PARAM_OUT);	/* record count */
+
+	memset(ftfx_fstat, 0, count);
+
+	for (unsigned int done = 0; done < count; ) {
+		unsigned int n = MIN(chunk, count - done);
+
+		memset(buf, 0, n * KINETIS_FTFX_BATCH_RECORD);
+		for (unsigned int i = 0; i < n; i++)
+			memcpy(buf + i * KINETIS_FTFX_BATCH_RECORD, commands + (done + i) * 12, 12);
+
+		retval = target_write_buffer(target, records->address,
+				n * KINETIS_FTFX_BATCH_RECORD, buf);
+		if (retval != ERROR_OK)
+			break;
+
+		buf_set_u32(reg_params[0].value, 0, 32, FTFX_FSTAT);
+		buf_set_u32(reg_params[1].value, 0, 32, records->address);
+		buf_set_u32(reg_params[2].value, 0, 32, n);
+
+		/* each command gets the same 250 ms as kinetis_ftfx_command() */
+		retval = target_run_algorithm(target, 0, NULL,
+				ARRAY_SIZE(reg_params), reg_params,
+				batch_algorithm->address,
+				batch_algorithm->address + sizeof(kinetis_ftfx_batch_code) - 2,
+				1000 + 250 * n, &armv7m_info);
+		if (retval != ERROR_OK) {
+			LOG_ERROR("Error executing kinetis FTFx command list");
+			break;
+		}
+
+		retval = target_read_buffer(target, records->address,
+				n * KINETIS_FTFX_BATCH_RECORD, buf);
+		if (retval != ERROR_OK)
+			break;
+
+		bool stopped = false;
+		for (unsigned int i = 0; i < n; i++) {
+			uint8_t fstat = buf[i * KINETIS_FTFX_BATCH_RECORD + 12];
+
+			ftfx_fstat[done + i] = fstat;
+			if (fstat & 0x70) {
+				stopped = true;
+				break;
+			}
+		}
+		if (stopped)
+			break;
+
+		done += n;
+	}
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(reg_params); i++)
+		destroy_reg_param(&reg_params[i]);
+
+	free(buf);
+	target_free_working_area(target, records);
+	target_free_working_area(target, batch_algorithm);
+
+	return retval;
+}
+
+
 static int kinetis_read_pmstat(struct kinetis_chip *k_chip, uint8_t *pmstat)
 {
 	int result;
@@ -3106,8 +3245,51 @@ static int kinetis_blank_check(struct flash_bank *bank)
 		}
 
 		if (block_dirty) {
-			/* the whole bank is not erased, check sector-by-sector */
-			for (unsigned int i = 0; i < bank->num_sectors; i++) {
+			/* the whole bank is not erased, check sector-by-sector,
+			 * preferably as one on-target command list */
+			unsigned int first = 0;
+			uint8_t *commands = NULL;
+			uint8_t *fstat = NULL;
+
+			/* the command list runs as a target algorithm, a running
+			 * target is checked by single commands only */
+			if (bank->target->state == TARGET_HALTED) {
+				commands = malloc(bank->num_sectors * 12);
+				fstat = malloc(bank->num_sectors);
+				if (commands && fstat)
+					kinetis_disable_wdog(k_chip);
+			}
+
+			while (commands && fstat && first < bank->num_sectors) {
+				unsigned int n = bank->num_sectors - first;
+
+				for (unsigned int i = 0; i < n; i++)
+					kinetis_ftfx_fill_fccob(commands + i * 12, FTFX_CMD_SECTSTAT,
+							k_bank->prog_base + bank->sectors[first + i].offset,
+							1, 0, 0, 0,  0, 0, 0, 0);	/* normal margin */
+
+				result = kinetis_ftfx_command_batch(bank->target, commands, n, fstat);
+				if (result == ERROR_TARGET_RESOURCE_NOT_AVAILABLE)
+					break;
+
+				unsigned int i;
+				for (i = 0; i < n && (fstat[i] & 0xf0) == 0x80; i++)
+					bank->sectors[first + i].is_erased = !(fstat[i] & 0x01);
+				first += i;
+
+				if (first < bank->num_sectors && (fstat[i] & 0x80)) {
+					/* this sector failed, go on with the next one */
+					LOG_DEBUG("Ignoring error on PFlash sector blank-check");
+					kinetis_ftfx_clear_error(bank->target);
+					bank->sectors[first++].is_erased = -1;
+				} else if (first < bank->num_sectors) {
+					break;
+				}
+			}
+			free(commands);
+			free(fstat);
+
+			for (unsigned int i = first; i < bank->num_sectors; i++) {
 				/* normal margin */
 				result = kinetis_ftfx_command(bank->target, FTFX_CMD_SECTSTAT,
 						k_bank->prog_base + bank->sectors[i].offset,
@@ -1100,23 +1100,50 @@ static int nrf5_erase(struct flash_bank *bank, unsigned int first,
 			return res;
 	}
 
-	/* For each sector to be erased */
-	for (unsigned int s = first; s <= last && res == ERROR_OK; s++) {
-
+	for (unsigned int s = first; s <= last; s++) {
 		if (chip->features & NRF5_FEATURE_SERIES_51
 				&& bank->sectors[s].is_protected == 1) {
 			LOG_ERROR("Flash sector %d is protected", s);
 			return ERROR_FLASH_PROTECTED;
 		}
+	}
+
+	/* UICR has its own erase rules, see nrf5_erase_page() */
+	if (bank->base == NRF5_UICR_BASE) {
+		for (unsigned int s = first; s <= last; s++) {
+			res = nrf5_erase_page(bank, chip, &bank->sectors[s]);
+			if (res != ERROR_OK) {
+				LOG_ERROR("Error erasing sector %d", s);
+				return res;
+			}
+		}
+		return ERROR_OK;
+	}
+
+	/* Keep NVMC erase-enabled for the whole range instead of switching
+	 * CONFIG (and waiting for it) around every page */
+	res = nrf5_nvmc_erase_enable(chip);
+	if (res != ERROR_OK)
+		goto error;
 
-		res = nrf5_erase_page(bank, chip, &bank->sectors[s]);
+	for (unsigned int s = first; s <= last; s++) {
+		LOG_DEBUG("Erasing page at 0x%"PRIx32, bank->sectors[s].offset);
+
+		res = target_write_u32(chip->target, NRF5_NVMC_ERASEPAGE,
+				bank->sectors[s].offset);
+		if (res == ERROR_OK)
+			res = nrf5_wait_for_nvmc(chip);
 		if (res != ERROR_OK) {
 			LOG_ERROR("Error erasing sector %d", s);
-			return res;
+			goto error;
 		}
 	}
 
-	return ERROR_OK;
+	return nrf5_nvmc_read_only(chip);
+
+error:
+	nrf5_nvmc_read_only(chip);
+	return res;
 }
 
 static void nrf5_free_driver_priv(struct flash_bank *bank)
@@ -211,6 +211,93 @@ static int rp2040_stack_grab_and_prep(struct flash_bank *bank)
 	return ERROR_OK;
 }
 
+/* Stream pages through a working area FIFO to a resident loader calling
+ * flash_range_program() page by page, so the host transfer of the next
+ * pages overlaps programming. Requires the stack prepared by
+ * rp2040_stack_grab_and_prep(). */
+static int rp2040_flash_write_async(struct flash_bank *bank, const uint8_t *buffer,
+		uint32_t offset, uint32_t count)
+{
+	struct rp2040_flash_bank *priv = bank->driver_priv;
+	struct target *target = bank->target;
+	struct working_area *write_algorithm;
+	struct working_area *fifo;
+	struct armv7m_algorithm armv7m_info;
+	uint32_t pagesize = priv->dev->pagesize;
+
+	static const uint8_t rp2040_write_code[] = {
+#include "../../../contrib/loaders/flash/rp2040/rp2040_write.inc"
+	};
+
+	if (!IS_PWR_OF_2(pagesize) || count % pagesize)
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+
+	if (target_alloc_working_area_try(target, sizeof(rp2040_write_code),
+			&write_algorithm) != ERROR_OK)
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+
+	int err = target_write_buffer(target, write_algorithm->address,
+			sizeof(rp2040_write_code), rp2040_write_code);
+	if (err != ERROR_OK) {
+		target_free_working_area(target, write_algorithm);
+		return err;
+	}
+
+	/* FIFO data area must hold whole pages; at least two of them to
+	 * overlap transfer and programming */
+	uint32_t avail_pages = target_get_working_area_avail(target);
+	avail_pages = avail_pages > 8 ? (avail_pages - 8) / pagesize : 0;
+	avail_pages = MIN(avail_pages, count / pagesize + 1);
+	if (avail_pages < 2 ||
+			target_alloc_working_area_try(target, 8 + avail_pages * pagesize,
+				&fifo) != ERROR_OK) {
+		target_free_working_area(target, write_algorithm);
+		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
+	}
+
+	LOG_DEBUG("Streaming %" PRIu32 " pages through a %" PRIu32 " page FIFO @" TARGET_ADDR_FMT,
+		count / pagesize, avail_pages, fifo->address);
+
+	struct reg_param reg_params[7];
+
+	init_reg_param(&reg_params[0], "r4", 32, PARAM_OUT);	/* workarea start */
+	init_reg_param(&reg_params[1], "r5", 32, PARAM_OUT);	/* workarea end */
+	init_reg_param(&reg_params[2], "r6", 32, PARAM_IN_OUT);	/* flash offset */
+	init_reg_param(&reg_params[3], "r7", 32, PARAM_OUT);	/* count (pages) */
+	init_reg_param(&reg_params[4], "r8", 32, PARAM_OUT);	/* ROM flash_range_program() */
+	init_reg_param(&reg_params[5], "r9", 32, PARAM_OUT);	/* page size */
+	init_reg_param(&reg_params[6], "sp", 32, PARAM_OUT);
+
+	buf_set_u32(reg_params[0].value, 0, 32, fifo->address);
+	buf_set_u32(reg_params[1].value, 0, 32, fifo->address + fifo->size);
+	buf_set_u32(reg_params[2].value, 0, 32, offset);
+	buf_set_u32(reg_params[3].value, 0, 32, count / pagesize);
+	buf_set_u32(reg_params[4].value, 0, 32, priv->jump_flash_range_program);
+	buf_set_u32(reg_params[5].value, 0, 32, pagesize);
+	buf_set_u32(reg_params[6].value, 0, 32, priv->stack->address + priv->stack->size);
+
+	armv7m_info.common_magic = ARMV7M_COMMON_MAGIC;
+	armv7m_info.core_mode = ARM_MODE_THREAD;
+
+	err = target_run_flash_async_algorithm(target, buffer, count / pagesize, pagesize,
+			0, NULL,
+			ARRAY_SIZE(reg_params), reg_params,
+			fifo->address, fifo->size,
+			write_algorithm->address, 0,
+			&armv7m_info);
+	if (err != ERROR_OK)
+		LOG_ERROR("flash write failed near offset 0x%" PRIx32,
+			buf_get_u32(reg_params[2].value, 0, 32));
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(reg_params); i++)
+		destroy_reg_param(&reg_params[i]);
+
+	target_free_working_area(target, fifo);
+	target_free_working_area(target, write_algorithm);
+
+	return err;
+}
+
 static int rp2040_flash_write(struct flash_bank *bank, const uint8_t *buffer, uint32_t offset, uint32_t count)
 {
 	LOG_DEBUG("Writing %d bytes starting at 0x%" PRIx32, count, offset);
@@ -229,6 +316,12 @@ static int rp2040_flash_write(struct flash_bank *bank, const uint8_t *buffer, ui
 	if (err != ERROR_OK)
 		goto cleanup;
 
+	err = rp2040_flash_write_async(bank, buffer, offset, count);
+	if (err != ERROR_TARGET_RESOURCE_NOT_AVAILABLE)
+		goto cleanup;
+
+	LOG_DEBUG("No FIFO working area, programming through a bounce buffer");
+
 	unsigned int avail_pages = target_get_working_area_avail(target) / priv->dev->pagesize;
 	/* We try to allocate working area rounded down to device page size,
 	 * al least 1 page, at most the write data size
@@ -319,6 +319,17 @@ static int set_mm_mode(struct flash_bank *bank)
 	return retval;
 }
 
+/* Check whether the saved controller setup is memory mapped mode */
+static bool mm_mode_configured(struct flash_bank *bank)
+{
+	struct stmqspi_flash_bank *stmqspi_info = bank->driver_priv;
+
+	if (IS_OCTOSPI)
+		return (stmqspi_info->saved_cr & OCTOSPI_MM_MODE) == OCTOSPI_MM_MODE;
+
+	return (stmqspi_info->saved_ccr & QSPI_MM_MODE) == QSPI_MM_MODE;
+}
+
 /* Read the status register of the external SPI flash chip(s). */
 static int read_status_reg(struct flash_bank *bank, uint16_t *status)
 {
@@ -1591,6 +1602,31 @@ static int stmqspi_read(struct flash_bank *bank, uint8_t *buffer,
 		count = bank->size - offset;
 	}
 
+	/* If "reset init" configured memory mapped mode, the controller already
+	 * uses the (quad/octal) read command chosen there. Read through the
+	 * mapped window in large memory blocks, no algorithm needed. */
+	if (mm_mode_configured(bank)) {
+		/* The very last word must not be accessed due to a silicon bug in
+		 * some devices, leave it to the indirect read below */
+		uint32_t mm_count = MIN(offset + count, bank->size - 4) - MIN(offset, bank->size - 4);
+
+		retval = ERROR_OK;
+		if (mm_count) {
+			retval = set_mm_mode(bank);
+			if (retval == ERROR_OK)
+				retval = target_read_buffer(target, bank->base + offset, mm_count, buffer);
+		}
+		if (retval == ERROR_OK) {
+			buffer += mm_count;
+			offset += mm_count;
+			count -= mm_count;
+			if (count == 0)
+				return ERROR_OK;
+		} else {
+			LOG_DEBUG("memory mapped read failed, falling back to indirect read");
+		}
+	}
+
 	/* Abort any previous operation */
 	retval = stmqspi_abort(bank);
 	if (retval != ERROR_OK)
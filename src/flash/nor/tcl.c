@@ -19,6 +19,9 @@
  * Implements Tcl commands used to access NOR flash facilities.
  */
 
+/* Transfer unit of the read_bank and verify_bank commands */
+#define FLASH_READ_CHUNK_SIZE	(1024 * 1024)
+
 COMMAND_HELPER(flash_command_get_bank_probe_optional, unsigned int name_index,
 	       struct flash_bank **bank, bool do_probe)
 {
@@ -178,48 +181,112 @@ COMMAND_HANDLER(handle_flash_probe_command)
 
 COMMAND_HANDLER(handle_flash_erase_check_command)
 {
-	bool blank = true;
-	if (CMD_ARGC != 1)
+	int retval = ERROR_OK;
+	if (CMD_ARGC < 1)
 		return ERROR_COMMAND_SYNTAX_ERROR;
 
-	struct flash_bank *p;
-	int retval = CALL_COMMAND_HANDLER(flash_command_get_bank, 0, &p);
-	if (retval != ERROR_OK)
-		return retval;
+	struct flash_bank **banks = calloc(CMD_ARGC, sizeof(*banks));
+	int *results = calloc(CMD_ARGC, sizeof(*results));
+	if (!banks || !results) {
+		LOG_ERROR("Out of memory");
+		free(banks);
+		free(results);
+		return ERROR_FAIL;
+	}
 
-	retval = p->driver->erase_check(p);
-	if (retval == ERROR_OK)
-		command_print(CMD, "successfully checked erase state");
-	else {
-		command_print(CMD,
-			"unknown error when checking erase state of flash bank #%s at "
-			TARGET_ADDR_FMT,
-			CMD_ARGV[0],
-			p->base);
+	for (unsigned int i = 0; i < CMD_ARGC; i++) {
+		retval = CALL_COMMAND_HANDLER(flash_command_get_bank, i, &banks[i]);
+		if (retval != ERROR_OK)
+			goto done;
 	}
 
-	for (unsigned int j = 0; j < p->num_sectors; j++) {
-		char *erase_state;
+	/* Banks using the default check on the same target are checked
+	 * together, with one run of the target's blank check algorithm. */
+	bool *checked = calloc(CMD_ARGC, sizeof(*checked));
+	struct flash_bank **group = calloc(CMD_ARGC, sizeof(*group));
+	if (!checked || !group) {
+		LOG_ERROR("Out of memory");
+		free(checked);
+		free(group);
+		retval = ERROR_FAIL;
+		goto done;
+	}
 
-		if (p->sectors[j].is_erased == 0)
-			erase_state = "not erased";
-		else if (p->sectors[j].is_erased == 1)
+	for (unsigned int i = 0; i < CMD_ARGC; i++) {
+		if (checked[i])
 			continue;
-		else
-			erase_state = "erase state unknown";
 
-		blank = false;
-		command_print(CMD,
-			"\t#%3i: 0x%8.8" PRIx32 " (0x%" PRIx32 " %" PRIu32 "kB) %s",
-			j,
-			p->sectors[j].offset,
-			p->sectors[j].size,
-			p->sectors[j].size >> 10,
-			erase_state);
+		if (banks[i]->driver->erase_check != default_flash_blank_check) {
+			results[i] = banks[i]->driver->erase_check(banks[i]);
+			checked[i] = true;
+			continue;
+		}
+
+		unsigned int num_group = 0;
+		for (unsigned int j = i; j < CMD_ARGC; j++) {
+			if (!checked[j]
+					&& banks[j]->driver->erase_check == default_flash_blank_check
+					&& banks[j]->target == banks[i]->target
+					&& banks[j]->erased_value == banks[i]->erased_value) {
+				group[num_group++] = banks[j];
+				checked[j] = true;
+			}
+		}
+
+		int group_retval = default_flash_blank_check_banks(group, num_group);
+		for (unsigned int j = i; j < CMD_ARGC; j++)
+			for (unsigned int k = 0; k < num_group; k++)
+				if (banks[j] == group[k])
+					results[j] = group_retval;
 	}
+	free(checked);
+	free(group);
+
+	for (unsigned int i = 0; i < CMD_ARGC; i++) {
+		struct flash_bank *p = banks[i];
+		bool blank = true;
 
-	if (blank)
-		command_print(CMD, "\tBank is erased");
+		if (CMD_ARGC > 1)
+			command_print(CMD, "flash bank #%s:", CMD_ARGV[i]);
+
+		if (results[i] == ERROR_OK)
+			command_print(CMD, "successfully checked erase state");
+		else {
+			command_print(CMD,
+				"unknown error when checking erase state of flash bank #%s at "
+				TARGET_ADDR_FMT,
+				CMD_ARGV[i],
+				p->base);
+			retval = results[i];
+		}
+
+		for (unsigned int j = 0; j < p->num_sectors; j++) {
+			char *erase_state;
+
+			if (p->sectors[j].is_erased == 0)
+				erase_state = "not erased";
+			else if (p->sectors[j].is_erased == 1)
+				continue;
+			else
+				erase_state = "erase state unknown";
+
+			blank = false;
+			command_print(CMD,
+				"\t#%3i: 0x%8.8" PRIx32 " (0x%" PRIx32 " %" PRIu32 "kB) %s",
+				j,
+				p->sectors[j].offset,
+				p->sectors[j].size,
+				p->sectors[j].size >> 10,
+				erase_state);
+		}
+
+		if (blank)
+			command_print(CMD, "\tBank is erased");
+	}
+
+done:
+	free(banks);
+	free(results);
 	return retval;
 }
 
@@ -885,19 +952,12 @@ COMMAND_HANDLER(handle_flash_read_bank_command)
 		return ERROR_COMMAND_ARGUMENT_INVALID;
 	}
 
-	buffer = malloc(length);
+	buffer = malloc(MIN(length, FLASH_READ_CHUNK_SIZE));
 	if (!buffer) {
 		LOG_ERROR("Out of memory");
 		return ERROR_FAIL;
 	}
 
-	retval = flash_driver_read(p, buffer, offset, length);
-	if (retval != ERROR_OK) {
-		LOG_ERROR("Read error");
-		free(buffer);
-		return retval;
-	}
-
 	retval = fileio_open(&fileio, CMD_ARGV[1], FILEIO_WRITE, FILEIO_BINARY);
 	if (retval != ERROR_OK) {
 		LOG_ERROR("Could not open file");
@@ -905,13 +965,35 @@ COMMAND_HANDLER(handle_flash_read_bank_command)
 		return retval;
 	}
 
-	retval = fileio_write(fileio, length, buffer, &written);
+	/* stream the bank in chunks, so neither the host memory nor the
+	 * time until the first data reaches the file scale with the length */
+	written = 0;
+	for (uint32_t done = 0; done < length; ) {
+		uint32_t chunk = MIN(length - done, FLASH_READ_CHUNK_SIZE);
+		size_t chunk_written;
+
+		retval = flash_driver_read(p, buffer, offset + done, chunk);
+		if (retval != ERROR_OK) {
+			LOG_ERROR("Read error");
+			break;
+		}
+
+		retval = fileio_write(fileio, chunk, buffer, &chunk_written);
+		if (retval != ERROR_OK || chunk_written != chunk) {
+			LOG_ERROR("Could not write file");
+			retval = ERROR_FAIL;
+			break;
+		}
+
+		done += chunk;
+		written += chunk_written;
+		LOG_DEBUG("read %" PRIu32 " of %" PRIu32 " bytes", done, length);
+		keep_alive();
+	}
 	fileio_close(fileio);
 	free(buffer);
-	if (retval != ERROR_OK) {
-		LOG_ERROR("Could not write file");
-		return ERROR_FAIL;
-	}
+	if (retval != ERROR_OK)
+		return retval;
 
 	if (duration_measure(&bench) == ERROR_OK)
 		command_print(CMD, "wrote %zd bytes to file %s from flash bank %u"
@@ -979,41 +1061,61 @@ COMMAND_HANDLER(handle_flash_verify_bank_command)
 		LOG_INFO("File content exceeds flash bank size. Only comparing the "
 			"first %zu bytes of the file", length);
 
-	buffer_file = malloc(length);
-	if (!buffer_file) {
+	size_t chunk_size = MIN(length, FLASH_READ_CHUNK_SIZE);
+	buffer_file = malloc(chunk_size);
+	buffer_flash = malloc(chunk_size);
+	if (!buffer_file || !buffer_flash) {
 		LOG_ERROR("Out of memory");
+		free(buffer_flash);
+		free(buffer_file);
 		fileio_close(fileio);
 		return ERROR_FAIL;
 	}
 
-	retval = fileio_read(fileio, length, buffer_file, &read_cnt);
-	fileio_close(fileio);
-	if (retval != ERROR_OK) {
-		LOG_ERROR("File read failure");
-		free(buffer_file);
-		return retval;
-	}
+	/* compare in chunks, keeping host memory bounded for large banks */
+	differ = 0;
+	int diffs = 0;
+	for (size_t done = 0; done < length; ) {
+		size_t chunk = MIN(length - done, chunk_size);
 
-	if (read_cnt != length) {
-		LOG_ERROR("Short read");
-		free(buffer_file);
-		return ERROR_FAIL;
-	}
+		retval = fileio_read(fileio, chunk, buffer_file, &read_cnt);
+		if (retval != ERROR_OK) {
+			LOG_ERROR("File read failure");
+			break;
+		}
 
-	buffer_flash = malloc(length);
-	if (!buffer_flash) {
-		LOG_ERROR("Out of memory");
-		free(buffer_file);
-		return ERROR_FAIL;
-	}
+		if (read_cnt != chunk) {
+			LOG_ERROR("Short read");
+			retval = ERROR_FAIL;
+			break;
+		}
 
-	retval = flash_driver_read(p, buffer_flash, offset, length);
-	if (retval != ERROR_OK) {
-		LOG_ERROR("Flash read error");
-		free(buffer_flash);
-		free(buffer_file);
-		return retval;
+		retval = flash_driver_read(p, buffer_flash, offset + done, chunk);
+		if (retval != ERROR_OK) {
+			LOG_ERROR("Flash read error");
+			break;
+		}
+
+		if (memcmp(buffer_file, buffer_flash, chunk)) {
+			differ = 1;
+			for (size_t t = 0; t < chunk && diffs < 128; t++) {
+				if (buffer_flash[t] == buffer_file[t])
+					continue;
+				command_print(CMD, "diff %d address 0x%08zx. Was 0x%02x instead of 0x%02x",
+						diffs, done + t + offset, buffer_flash[t], buffer_file[t]);
+				if (diffs++ >= 127)
+					command_print(CMD, "More than 128 errors, the rest are not printed.");
+			}
+		}
+
+		done += chunk;
+		keep_alive();
 	}
+	fileio_close(fileio);
+	free(buffer_flash);
+	free(buffer_file);
+	if (retval != ERROR_OK)
+		return retval;
 
 	if (duration_measure(&bench) == ERROR_OK)
 		command_print(CMD, "read %zd bytes from file %s and flash bank %u"
@@ -1021,25 +1123,7 @@ COMMAND_HANDLER(handle_flash_verify_bank_command)
 			length, CMD_ARGV[1], p->bank_number, offset,
 			duration_elapsed(&bench), duration_kbps(&bench, length));
 
-	differ = memcmp(buffer_file, buffer_flash, length);
 	command_print(CMD, "contents %s", differ ? "differ" : "match");
-	if (differ) {
-		uint32_t t;
-		int diffs = 0;
-		for (t = 0; t < length; t++) {
-			if (buffer_flash[t] == buffer_file[t])
-				continue;
-			command_print(CMD, "diff %d address 0x%08" PRIx32 ". Was 0x%02x instead of 0x%02x",
-					diffs, t + offset, buffer_flash[t], buffer_file[t]);
-			if (diffs++ >= 127) {
-				command_print(CMD, "More than 128 errors, the rest are not printed.");
-				break;
-			}
-			keep_alive();
-		}
-	}
-	free(buffer_flash);
-	free(buffer_file);
 
 	return differ ? ERROR_FAIL : ERROR_OK;
 }
@@ -1092,9 +1176,9 @@ static const struct command_registration flash_exec_command_handlers[] = {
 		.name = "erase_check",
 		.handler = handle_flash_erase_check_command,
 		.mode = COMMAND_EXEC,
-		.usage = "bank_id",
-		.help = "Check erase state of all blocks in a "
-			"flash bank.",
+		.usage = "bank_id [bank_id ...]",
+		.help = "Check erase state of all blocks in one or more "
+			"flash banks.",
 	},
 	{
 		.name = "erase_sector",
@@ -27,6 +27,9 @@
  * bit target!
  */
 
+/* upper bound of list_width and of the list item fields read */
+#define FREERTOS_LIST_MAX_WIDTH 32
+
 struct freertos_params {
 	const char *target_name;
 	const unsigned char thread_count_width;
@@ -268,52 +271,73 @@ static int freertos_update_threads(struct rtos *rtos)
 	list_of_lists[num_lists++] = rtos->symbols[FREERTOS_VAL_X_SUSPENDED_TASK_LIST].address;
 	list_of_lists[num_lists++] = rtos->symbols[FREERTOS_VAL_X_TASKS_WAITING_TERMINATION].address;
 
+	/* The ready lists are one contiguous array, fetch all of their
+	 * headers with a single read instead of two reads per priority */
+	uint8_t *ready_lists = malloc(config_max_priorities * param->list_width);
+	if (!ready_lists) {
+		LOG_ERROR("Error allocating memory for %u priorities", config_max_priorities);
+		free(list_of_lists);
+		return ERROR_FAIL;
+	}
+	retval = target_read_buffer(rtos->target,
+			rtos->symbols[FREERTOS_VAL_PX_READY_TASKS_LISTS].address,
+			config_max_priorities * param->list_width, ready_lists);
+	if (retval != ERROR_OK) {
+		LOG_ERROR("Error reading FreeRTOS ready task lists");
+		free(ready_lists);
+		free(list_of_lists);
+		return retval;
+	}
+
 	for (unsigned int i = 0; i < num_lists; i++) {
 		if (list_of_lists[i] == 0)
 			continue;
 
-		/* Read the number of threads in this list */
-		uint32_t list_thread_count = 0;
-		retval = target_read_u32(rtos->target,
-				list_of_lists[i],
-				&list_thread_count);
-		if (retval != ERROR_OK) {
-			LOG_ERROR("Error reading number of threads in FreeRTOS thread list");
-			free(list_of_lists);
-			return retval;
+		/* Read the list header: number of threads and first list item */
+		uint8_t list_buf[FREERTOS_LIST_MAX_WIDTH];
+		const uint8_t *list_hdr = list_buf;
+		if (i < config_max_priorities) {
+			list_hdr = ready_lists + i * param->list_width;
+		} else {
+			retval = target_read_buffer(rtos->target, list_of_lists[i],
+					param->list_width, list_buf);
+			if (retval != ERROR_OK) {
+				LOG_ERROR("Error reading FreeRTOS thread list header");
+				free(ready_lists);
+				free(list_of_lists);
+				return retval;
+			}
 		}
+
+		uint32_t list_thread_count = target_buffer_get_u32(rtos->target, list_hdr);
 		LOG_DEBUG("FreeRTOS: Read thread count for list %u at 0x%" PRIx64 ", value %" PRIu32,
 										i, list_of_lists[i], list_thread_count);
 
 		if (list_thread_count == 0)
 			continue;
 
-		/* Read the location of first list item */
 		uint32_t prev_list_elem_ptr = -1;
-		uint32_t list_elem_ptr = 0;
-		retval = target_read_u32(rtos->target,
-				list_of_lists[i] + param->list_next_offset,
-				&list_elem_ptr);
-		if (retval != ERROR_OK) {
-			LOG_ERROR("Error reading first thread item location in FreeRTOS thread list");
-			free(list_of_lists);
-			return retval;
-		}
+		uint32_t list_elem_ptr = target_buffer_get_u32(rtos->target,
+				list_hdr + param->list_next_offset);
 		LOG_DEBUG("FreeRTOS: Read first item for list %u at 0x%" PRIx64 ", value 0x%" PRIx32,
 										i, list_of_lists[i] + param->list_next_offset, list_elem_ptr);
 
 		while ((list_thread_count > 0) && (list_elem_ptr != 0) &&
 				(list_elem_ptr != prev_list_elem_ptr) &&
 				(tasks_found < thread_list_size)) {
-			/* Get the location of the thread structure. */
-			retval = target_read_u32(rtos->target,
-					list_elem_ptr + param->list_elem_content_offset,
-					&pointer_casts_are_bad);
+			/* Read the list item: next item and owning thread structure */
+			uint8_t elem_buf[FREERTOS_LIST_MAX_WIDTH];
+			retval = target_read_buffer(rtos->target, list_elem_ptr,
+					MAX(param->list_elem_next_offset,
+						param->list_elem_content_offset) + 4, elem_buf);
 			if (retval != ERROR_OK) {
 				LOG_ERROR("Error reading thread list item object in FreeRTOS thread list");
+				free(ready_lists);
 				free(list_of_lists);
 				return retval;
 			}
+			pointer_casts_are_bad = target_buffer_get_u32(rtos->target,
+					elem_buf + param->list_elem_content_offset);
 			rtos->thread_details[tasks_found].threadid = pointer_casts_are_bad;
 			LOG_DEBUG("FreeRTOS: Read Thread ID at 0x%" PRIx32 ", value 0x%" PRIx64,
 										list_elem_ptr + param->list_elem_content_offset,
@@ -331,6 +355,7 @@ static int freertos_update_threads(struct rtos *rtos)
 					(uint8_t *)&tmp_str);
 			if (retval != ERROR_OK) {
 				LOG_ERROR("Error reading first thread item location in FreeRTOS thread list");
+				free(ready_lists);
 				free(list_of_lists);
 				return retval;
 			}
@@ -361,21 +386,15 @@ static int freertos_update_threads(struct rtos *rtos)
 			rtos->thread_count = tasks_found;
 
 			prev_list_elem_ptr = list_elem_ptr;
-			list_elem_ptr = 0;
-			retval = target_read_u32(rtos->target,
-					prev_list_elem_ptr + param->list_elem_next_offset,
-					&list_elem_ptr);
-			if (retval != ERROR_OK) {
-				LOG_ERROR("Error reading next thread item location in FreeRTOS thread list");
-				free(list_of_lists);
-				return retval;
-			}
+			list_elem_ptr = target_buffer_get_u32(rtos->target,
+					elem_buf + param->list_elem_next_offset);
 			LOG_DEBUG("FreeRTOS: Read next thread location at 0x%" PRIx32 ", value 0x%" PRIx32,
 										prev_list_elem_ptr + param->list_elem_next_offset,
 										list_elem_ptr);
 		}
 	}
 
+	free(ready_lists);
 	free(list_of_lists);
 	return 0;
 }
@@ -24,8 +24,9 @@
 
 #define LINUX_USER_KERNEL_BORDER 0xc0000000
 #include "linux_header.h"
-#define PHYS
 #define MAX_THREADS 200
+/*  part of task_struct read at once, up to the last field used  */
+#define TASK_SLICE_SIZE MAX(MAX(MAX(ONCPU, NEXT), MAX(MEM, PID)) + 4, COMM + 16)
 /*  specific task  */
 struct linux_os {
 	const char *name;
@@ -64,6 +65,8 @@ struct threads {
 	int status;		/* dead = 1 alive = 2 current = 3 alive and current */
 	/*  value that should not change during the live of a thread ? */
 	uint32_t thread_info_addr;	/*  contain latest thread_info_addr computed */
+	uint32_t tasks_next;	/*  tasks.next read by fill_task ...  */
+	uint32_t tasks_next_base;	/*  ... for the task_struct at this address  */
 	/*  retrieve from thread_info */
 	struct cpu_context *context;
 	struct threads *next;
@@ -118,20 +121,13 @@ static int linux_read_memory(struct target *target,
 	uint32_t address, uint32_t size, uint32_t count,
 	uint8_t *buffer)
 {
-#ifdef PHYS
-	struct linux_os *linux_os = (struct linux_os *)
-		target->rtos->rtos_specific_params;
-	uint32_t pa = (address & linux_os->phys_mask) + linux_os->phys_base;
-#endif
 	if (address < 0xc0000000) {
 		LOG_ERROR("linux awareness : address in user space");
 		return ERROR_FAIL;
 	}
-#ifdef PHYS
-	target_read_phys_memory(target, pa, size, count, buffer);
-#endif
-	target_read_memory(target, address, size, count, buffer);
-	return ERROR_OK;
+	/*  kernel addresses are read through the MMU, an extra physical
+	 *  read of the same data was overwritten here anyway  */
+	return target_read_memory(target, address, size, count, buffer);
 }
 
 static int fill_buffer(struct target *target, uint32_t addr, uint8_t *buffer)
@@ -280,104 +276,71 @@ int fill_task_pid(struct target *target, struct threads *t)
 }
 #endif
 
+static void decode_name(struct target *target, struct threads *t,
+	const uint8_t *comm)
+{
+	memset(t->name, 0, sizeof(t->name));
+
+	for (int i = 0; i < 16; i += 4) {
+		uint32_t raw_name = target_buffer_get_u32(target, comm + i);
+		t->name[i + 3] = raw_name >> 24;
+		t->name[i + 2] = raw_name >> 16;
+		t->name[i + 1] = raw_name >> 8;
+		t->name[i] = raw_name;
+	}
+}
+
+/*  fill state, pid, oncpu, asid, name and tasks.next of a task_struct,
+ *  the task_struct fields are read with a single block transfer  */
 static int fill_task(struct target *target, struct threads *t)
 {
 	int retval;
-	uint32_t pid_addr = t->base_addr + PID;
-	uint32_t mem_addr = t->base_addr + MEM;
-	uint32_t on_cpu = t->base_addr + ONCPU;
-	uint8_t *buffer = calloc(1, 4);
-	retval = fill_buffer(target, t->base_addr, buffer);
-
-	if (retval == ERROR_OK) {
-		uint32_t val = get_buffer(target, buffer);
-		t->state = val;
-	} else
-		LOG_ERROR("fill_task: unable to read memory");
-
-	retval = fill_buffer(target, pid_addr, buffer);
-
-	if (retval == ERROR_OK) {
-		uint32_t val = get_buffer(target, buffer);
-		t->pid = val;
-	} else
-		LOG_ERROR("fill task: unable to read memory");
-
-	retval = fill_buffer(target, on_cpu, buffer);
-
-	if (retval == ERROR_OK) {
-		uint32_t val = get_buffer(target, buffer);
-		t->oncpu = val;
-	} else
-		LOG_ERROR("fill task: unable to read memory");
+	uint8_t slice[(TASK_SLICE_SIZE + 3) & ~3] = { 0 };
+	uint8_t buffer[4];
 
-	retval = fill_buffer(target, mem_addr, buffer);
+	/*  never follow a tasks.next left over from a failed read  */
+	t->tasks_next = 0;
+	retval = linux_read_memory(target, t->base_addr, 4, sizeof(slice) / 4, slice);
 
-	if (retval == ERROR_OK) {
-		uint32_t val = get_buffer(target, buffer);
+	if (retval != ERROR_OK) {
+		LOG_ERROR("fill_task: unable to read memory");
+		return retval;
+	}
 
-		if (val != 0) {
-			uint32_t asid_addr = val + MM_CTX;
-			retval = fill_buffer(target, asid_addr, buffer);
+	t->state = get_buffer(target, slice);
+	t->pid = get_buffer(target, slice + PID);
+	t->oncpu = get_buffer(target, slice + ONCPU);
+	t->tasks_next = get_buffer(target, slice + NEXT);
+	t->tasks_next_base = t->base_addr;
+	decode_name(target, t, slice + COMM);
 
-			if (retval == ERROR_OK) {
-				val = get_buffer(target, buffer);
-				t->asid = val;
-			} else
-				LOG_ERROR
-					("fill task: unable to read memory -- ASID");
-		} else
-			t->asid = 0;
-	} else
-		LOG_ERROR("fill task: unable to read memory");
+	uint32_t val = get_buffer(target, slice + MEM);
 
-	free(buffer);
+	t->asid = 0;
+	if (val != 0) {
+		retval = fill_buffer(target, val + MM_CTX, buffer);
+		if (retval == ERROR_OK)
+			t->asid = get_buffer(target, buffer);
+		else
+			LOG_ERROR("fill task: unable to read memory -- ASID");
+	}
 
-	return retval;
+	return ERROR_OK;
 }
 
 static int get_name(struct target *target, struct threads *t)
 {
 	int retval;
-	uint32_t full_name[4];
-	uint32_t comm = t->base_addr + COMM;
-	int i;
+	uint8_t comm[16];
 
-	for (i = 0; i < 17; i++)
-		t->name[i] = 0;
-
-	retval = linux_read_memory(target, comm, 4, 4, (uint8_t *) full_name);
+	retval = linux_read_memory(target, t->base_addr + COMM, 4, 4, comm);
 
 	if (retval != ERROR_OK) {
 		LOG_ERROR("get_name: unable to read memory\n");
 		return ERROR_FAIL;
 	}
 
-	uint32_t raw_name = target_buffer_get_u32(target,
-			(const uint8_t *)
-			&full_name[0]);
-	t->name[3] = raw_name >> 24;
-	t->name[2] = raw_name >> 16;
-	t->name[1] = raw_name >> 8;
-	t->name[0] = raw_name;
-	raw_name =
-		target_buffer_get_u32(target, (const uint8_t *)&full_name[1]);
-	t->name[7] = raw_name >> 24;
-	t->name[6] = raw_name >> 16;
-	t->name[5] = raw_name >> 8;
-	t->name[4] = raw_name;
-	raw_name =
-		target_buffer_get_u32(target, (const uint8_t *)&full_name[2]);
-	t->name[11] = raw_name >> 24;
-	t->name[10] = raw_name >> 16;
-	t->name[9] = raw_name >> 8;
-	t->name[8] = raw_name;
-	raw_name =
-		target_buffer_get_u32(target, (const uint8_t *)&full_name[3]);
-	t->name[15] = raw_name >> 24;
-	t->name[14] = raw_name >> 16;
-	t->name[13] = raw_name >> 8;
-	t->name[12] = raw_name;
+	decode_name(target, t, comm);
 	return ERROR_OK;
 
 }
@@ -445,7 +408,6 @@ static int get_current(struct target *target, int create)
 					t = calloc(1, sizeof(struct threads));
 					t->base_addr = ct->TS;
 					fill_task(target, t);
-					get_name(target, t);
 					t->oncpu = cpu;
 					insert_into_threadlist(target, t);
 					t->status = 3;
@@ -566,6 +528,10 @@ retry:
 
 static uint32_t next_task(struct target *target, struct threads *t)
 {
+	/*  already read along with the rest of the task_struct  */
+	if (t->tasks_next && t->tasks_next_base == t->base_addr)
+		return t->tasks_next - NEXT;
+
 	uint8_t *buffer = calloc(1, 4);
 	uint32_t next_addr = t->base_addr + NEXT;
 	int retval = fill_buffer(target, next_addr, buffer);
@@ -693,8 +659,7 @@ static int linux_get_tasks(struct target *target, int context)
 	while (((t->base_addr != linux_os->init_task_addr) &&
 		(t->base_addr != 0)) || (loop == 0)) {
 		loop++;
-		fill_task(target, t);
-		retval = get_name(target, t);
+		retval = fill_task(target, t);
 
 		if (loop > MAX_THREADS) {
 			free(t);
@@ -859,7 +824,6 @@ error_handling:
 				if (fill_task(target, t) != ERROR_OK)
 					goto error_handling;
 
-				get_name(target, t);
 				insert_into_threadlist(target, t);
 				t->thread_info_addr = 0xdeadbeef;
 			}
@@ -994,7 +958,6 @@ static int linux_task_update(struct target *target, int context)
 		if (found == 0) {
 			uint32_t base_addr;
 			fill_task(target, t);
-			get_name(target, t);
 			retval = insert_into_threadlist(target, t);
 			t->thread_info_addr = 0xdeadbeef;
 
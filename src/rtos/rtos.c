@@ -594,11 +594,44 @@ int rtos_set_reg(struct connection *connection, int reg_num,
 			(target->rtos->type->set_reg) &&
 			(current_threadid != -1) &&
 			(current_threadid != 0)) {
+		rtos_stack_cache_invalidate(target->rtos);
 		return target->rtos->type->set_reg(target->rtos, reg_num, reg_value);
 	}
 	return ERROR_FAIL;
 }
 
+/* A stacked register frame of a suspended thread, kept until the thread
+ * list is refreshed so that repeated register requests from gdb ('g', 'p',
+ * thread switches) for the same thread don't re-read target memory. */
+struct rtos_stack_frame {
+	struct rtos_stack_frame *next;
+	const struct rtos_register_stacking *stacking;
+	uint32_t address;
+	uint8_t data[];
+};
+
+void rtos_stack_cache_invalidate(struct rtos *rtos)
+{
+	struct rtos_stack_frame *frame = rtos->stack_frames;
+
+	while (frame) {
+		struct rtos_stack_frame *next = frame->next;
+		free(frame);
+		frame = next;
+	}
+	rtos->stack_frames = NULL;
+}
+
+static struct rtos_stack_frame *rtos_stack_cache_find(struct rtos *rtos,
+		const struct rtos_register_stacking *stacking, uint32_t address)
+{
+	for (struct rtos_stack_frame *frame = rtos->stack_frames; frame; frame = frame->next) {
+		if (frame->stacking == stacking && frame->address == address)
+			return frame;
+	}
+	return NULL;
+}
+
 int rtos_generic_stack_read(struct target *target,
 	const struct rtos_register_stacking *stacking,
 	int64_t stack_ptr,
@@ -611,22 +644,44 @@ int rtos_generic_stack_read(struct target *target,
 		LOG_ERROR("Error: null stack pointer in thread");
 		return -5;
 	}
-	/* Read the stack */
-	uint8_t *stack_data = malloc(stacking->stack_registers_size);
 	uint32_t address = stack_ptr;
 
 	if (stacking->stack_growth_direction == 1)
 		address -= stacking->stack_registers_size;
-	if (stacking->read_stack)
-		retval = stacking->read_stack(target, address, stacking, stack_data);
-	else
-		retval = target_read_buffer(target, address, stacking->stack_registers_size, stack_data);
-	if (retval != ERROR_OK) {
-		free(stack_data);
-		LOG_ERROR("Error reading stack frame from thread");
-		return retval;
+
+	struct rtos_stack_frame *frame = NULL;
+	if (target->rtos)
+		frame = rtos_stack_cache_find(target->rtos, stacking, address);
+
+	if (!frame) {
+		/* Read the stack */
+		frame = malloc(sizeof(*frame) + stacking->stack_registers_size);
+		if (!frame) {
+			LOG_ERROR("Out of memory");
+			return ERROR_FAIL;
+		}
+		frame->stacking = stacking;
+		frame->address = address;
+
+		if (stacking->read_stack)
+			retval = stacking->read_stack(target, address, stacking, frame->data);
+		else
+			retval = target_read_buffer(target, address, stacking->stack_registers_size, frame->data);
+		if (retval != ERROR_OK) {
+			free(frame);
+			LOG_ERROR("Error reading stack frame from thread");
+			return retval;
+		}
+		LOG_DEBUG("RTOS: Read stack frame at 0x%" PRIx32, address);
+
+		if (target->rtos) {
+			frame->next = target->rtos->stack_frames;
+			target->rtos->stack_frames = frame;
+		} else {
+			frame->next = NULL;
+		}
 	}
-	LOG_DEBUG("RTOS: Read stack frame at 0x%" PRIx32, address);
+	const uint8_t *stack_data = frame->data;
 
 #if 0
 		LOG_OUTPUT("Stack Data :");
@@ -658,7 +713,8 @@ int rtos_generic_stack_read(struct target *target,
 			buf_cpy(stack_data + offset, (*reg_list)[i].value, (*reg_list)[i].size);
 	}
 
-	free(stack_data);
+	if (!target->rtos)
+		free(frame);
 /*	LOG_OUTPUT("Output register string: %s\r\n", *hex_reg_list); */
 	return ERROR_OK;
 }
@@ -687,6 +743,8 @@ static int rtos_try_next(struct target *target)
 
 int rtos_update_threads(struct target *target)
 {
+	if (target->rtos)
+		rtos_stack_cache_invalidate(target->rtos);
 	if ((target->rtos) && (target->rtos->type))
 		target->rtos->type->update_threads(target->rtos);
 	return ERROR_OK;
@@ -694,6 +752,8 @@ int rtos_update_threads(struct target *target)
 
 void rtos_free_threadlist(struct rtos *rtos)
 {
+	rtos_stack_cache_invalidate(rtos);
+
 	if (rtos->thread_details) {
 		int j;
 
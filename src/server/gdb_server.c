@@ -35,6 +35,7 @@
 #include <target/semihosting_common.h>
 #include "server.h"
 #include <flash/nor/core.h>
+#include <helper/time_support.h>
 #include "gdb_server.h"
 #include <target/image.h>
 #include <jtag/jtag.h>
@@ -57,11 +58,6 @@ enum gdb_output_flag {
 	GDB_OUTPUT_ALL,
 };
 
-struct target_desc_format {
-	char *tdesc;
-	uint32_t tdesc_length;
-};
-
 /* private connection data for GDB */
 struct gdb_connection {
 	char buffer[GDB_BUFFER_SIZE + 1]; /* Extra byte for null-termination */
@@ -89,14 +85,16 @@ struct gdb_connection {
 	bool attached;
 	/* set when extended protocol is used */
 	bool extended_protocol;
-	/* temporarily used for target description support */
-	struct target_desc_format target_desc;
 	/* temporarily used for thread list support */
 	char *thread_list;
 	/* flag to mask the output from gdb_log_callback() */
 	enum gdb_output_flag output_flag;
 	/* Unique index for this GDB connection. */
 	unsigned int unique_index;
+	/* set when gdb switched to non-stop mode with QNonStop:1 */
+	bool non_stop;
+	/* set by a vCont;t action, the resulting stop is reported with signal 0 */
+	bool stop_requested;
 };
 
 #if 0
@@ -518,6 +516,41 @@ static int gdb_put_packet_inner(struct connection *connection,
 	return ERROR_OK;
 }
 
+/* Notifications are framed with '%' instead of '$' and are not acknowledged
+ * by gdb, even outside of noack mode. */
+static int gdb_put_notification(struct connection *connection,
+		const char *name, const char *buffer, int len)
+{
+	struct gdb_connection *gdb_con = connection->priv;
+	char local_buffer[256];
+	unsigned char my_checksum = 0;
+	int name_len = strlen(name);
+
+	if (name_len + 1 + len + 4 > (int)sizeof(local_buffer)) {
+		LOG_ERROR("gdb notification too long");
+		return ERROR_FAIL;
+	}
+
+	local_buffer[0] = '%';
+	memcpy(local_buffer + 1, name, name_len);
+	local_buffer[1 + name_len] = ':';
+	memcpy(local_buffer + 2 + name_len, buffer, len);
+	for (int i = 1; i < 2 + name_len + len; i++)
+		my_checksum += local_buffer[i];
+	int total = 2 + name_len + len;
+	total += snprintf(local_buffer + total, sizeof(local_buffer) - total, "#%02x", my_checksum);
+
+	LOG_DEBUG("{%d} sending notification: %.*s", gdb_con->unique_index, total, local_buffer);
+
+	gdb_con->busy = true;
+	int retval = gdb_write(connection, local_buffer, total);
+	gdb_con->busy = false;
+
+	kept_alive();
+
+	return retval;
+}
+
 int gdb_put_packet(struct connection *connection, char *buffer, int len)
 {
 	struct gdb_connection *gdb_con = connection->priv;
@@ -531,6 +564,17 @@ int gdb_put_packet(struct connection *connection, char *buffer, int len)
 	return retval;
 }
 
+/* In non-stop mode stop replies are sent asynchronously as %Stop
+ * notifications, the resume request itself has already been answered. */
+static int gdb_put_stop_reply(struct connection *connection, char *buffer, int len)
+{
+	struct gdb_connection *gdb_con = connection->priv;
+
+	if (gdb_con->non_stop)
+		return gdb_put_notification(connection, "Stop", buffer, len);
+	return gdb_put_packet(connection, buffer, len);
+}
+
 static inline int fetch_packet(struct connection *connection,
 		int *checksum_ok, int noack, int *len, char *buffer)
 {
@@ -790,6 +834,9 @@ static void gdb_signal_reply(struct target *target, struct connection *connectio
 		if (gdb_connection->ctrl_c) {
 			LOG_TARGET_DEBUG(target, "Responding with signal 2 (SIGINT) to debugger due to Ctrl-C");
 			signal_var = 0x2;
+		} else if (gdb_connection->stop_requested) {
+			/* gdb expects signal 0 for threads stopped by vCont;t */
+			signal_var = 0x0;
 		} else
 			signal_var = gdb_last_signal(ct);
 
@@ -828,9 +875,10 @@ static void gdb_signal_reply(struct target *target, struct connection *connectio
 				signal_var, stop_reason, current_thread);
 
 		gdb_connection->ctrl_c = false;
+		gdb_connection->stop_requested = false;
 	}
 
-	gdb_put_packet(connection, sig_reply, sig_reply_len);
+	gdb_put_stop_reply(connection, sig_reply, sig_reply_len);
 	gdb_connection->frontend_state = TARGET_HALTED;
 }
 
@@ -995,9 +1043,9 @@ static int gdb_new_connection(struct connection *connection)
 	gdb_connection->mem_write_error = false;
 	gdb_connection->attached = true;
 	gdb_connection->extended_protocol = false;
-	gdb_connection->target_desc.tdesc = NULL;
-	gdb_connection->target_desc.tdesc_length = 0;
 	gdb_connection->thread_list = NULL;
+	gdb_connection->non_stop = false;
+	gdb_connection->stop_requested = false;
 	gdb_connection->output_flag = GDB_OUTPUT_NO;
 	gdb_connection->unique_index = next_unique_id++;
 
@@ -1071,6 +1119,8 @@ static int gdb_new_connection(struct connection *connection)
 		return ERROR_TARGET_NOT_EXAMINED;
 	}
 	gdb_actual_connections++;
+	struct gdb_service *gdb_service = connection->service->priv;
+	gdb_service->connection_count++;
 
 	if (target->state != TARGET_HALTED)
 		LOG_WARNING("GDB connection %d on target %s not halted",
@@ -1101,6 +1151,19 @@ static int gdb_connection_closed(struct connection *connection)
 	log_remove_callback(gdb_log_callback, connection);
 
 	gdb_actual_connections--;
+
+	/* drop the shared XML with the last connection, the next debugger
+	 * may find a different flash or register layout */
+	struct gdb_service *gdb_service = connection->service->priv;
+	if (--gdb_service->connection_count == 0) {
+		free(gdb_service->tdesc);
+		gdb_service->tdesc = NULL;
+		gdb_service->tdesc_length = 0;
+		free(gdb_service->memory_map);
+		gdb_service->memory_map = NULL;
+		gdb_service->memory_map_length = 0;
+	}
+
 	LOG_DEBUG("{%d} GDB Close, Target: %s, state: %s, gdb_actual_connections=%d",
 		gdb_connection->unique_index,
 		target_name(target),
@@ -1151,6 +1214,12 @@ static int gdb_last_signal_packet(struct connection *connection,
 		return ERROR_OK;
 	}
 
+	/* in non-stop mode a running target has no stop to report */
+	if (gdb_con->non_stop && target->state == TARGET_RUNNING) {
+		gdb_put_packet(connection, "OK", 2);
+		return ERROR_OK;
+	}
+
 	signal_var = gdb_last_signal(target);
 
 	snprintf(sig_reply, 4, "S%2.2x", signal_var);
@@ -1900,35 +1969,22 @@ static int compare_bank(const void *a, const void *b)
 		return -1;
 }
 
-static int gdb_memory_map(struct connection *connection,
-		char const *packet, int packet_size)
+static int gdb_generate_memory_map(struct target *target, char **xml_out, uint32_t *length_out)
 {
 	/* We get away with only specifying flash here. Regions that are not
 	 * specified are treated as if we provided no memory map(if not we
 	 * could detect the holes and mark them as RAM).
-	 * Normally we only execute this code once, but no big deal if we
-	 * have to regenerate it a couple of times.
 	 */
 
-	struct target *target = get_target_from_connection(connection);
 	struct flash_bank *p;
 	char *xml = NULL;
 	int size = 0;
 	int pos = 0;
 	int retval = ERROR_OK;
 	struct flash_bank **banks;
-	int offset;
-	int length;
-	char *separator;
 	target_addr_t ram_start = 0;
 	unsigned int target_flash_banks = 0;
 
-	/* skip command character */
-	packet += 23;
-
-	offset = strtoul(packet, &separator, 16);
-	length = strtoul(separator + 1, &separator, 16);
-
 	xml_printf(&retval, &xml, &pos, &size, "<memory-map>\n");
 
 	/* Sort banks in ascending order.  We need to report non-flash
@@ -1944,7 +2000,7 @@ static int gdb_memory_map(struct connection *connection,
 		retval = get_flash_bank_by_num(i, &p);
 		if (retval != ERROR_OK) {
 			free(banks);
-			gdb_error(connection, retval);
+			free(xml);
 			return retval;
 		}
 		banks[target_flash_banks++] = p;
@@ -2030,20 +2086,65 @@ static int gdb_memory_map(struct connection *connection,
 
 	if (retval != ERROR_OK) {
 		free(xml);
-		gdb_error(connection, retval);
 		return retval;
 	}
 
-	if (offset + length > pos)
-		length = pos - offset;
+	*xml_out = xml;
+	*length_out = pos;
+	return ERROR_OK;
+}
+
+static int gdb_memory_map(struct connection *connection,
+		char const *packet, int packet_size)
+{
+	/* The map is generated once and shared by all connections of the
+	 * service, gdb usually fetches it in several chunks. */
+	struct gdb_service *gdb_service = connection->service->priv;
+	struct target *target = get_target_from_connection(connection);
+	uint32_t offset;
+	uint32_t length;
+	char *separator;
+	int retval;
+
+	/* skip command character */
+	packet += 23;
+
+	offset = strtoul(packet, &separator, 16);
+	length = strtoul(separator + 1, &separator, 16);
+
+	if (!gdb_service->memory_map) {
+		int64_t start = timeval_ms();
+		retval = gdb_generate_memory_map(target, &gdb_service->memory_map,
+				&gdb_service->memory_map_length);
+		if (retval != ERROR_OK) {
+			gdb_error(connection, retval);
+			return retval;
+		}
+		LOG_DEBUG("generated memory map for %s: %" PRIu32 " bytes in %" PRId64 " ms",
+				target_name(target), gdb_service->memory_map_length, timeval_ms() - start);
+	}
+
+	uint32_t map_length = gdb_service->memory_map_length;
+	if (offset > map_length)
+		offset = map_length;
+
+	char transfer_type = 'l';
+	if (length < map_length - offset)
+		transfer_type = 'm';
+	else
+		length = map_length - offset;
 
 	char *t = malloc(length + 1);
-	t[0] = 'l';
-	memcpy(t + 1, xml + offset, length);
+	if (!t) {
+		LOG_ERROR("Unable to allocate memory");
+		gdb_error(connection, ERROR_FAIL);
+		return ERROR_FAIL;
+	}
+	t[0] = transfer_type;
+	memcpy(t + 1, gdb_service->memory_map + offset, length);
 	gdb_put_packet(connection, t, length + 1);
 
 	free(t);
-	free(xml);
 	return ERROR_OK;
 }
 
@@ -2547,27 +2648,70 @@ error:
 	return retval;
 }
 
-static int gdb_get_target_description_chunk(struct target *target, struct target_desc_format *target_desc,
-		char **chunk, int32_t offset, uint32_t length)
+/* Cheap fingerprint of the register list a target description is generated
+ * from. Targets like riscv or xtensa may add or drop registers when they are
+ * (re-)examined, a changed fingerprint makes the cached description stale. */
+static uint32_t gdb_reg_layout_signature(struct target *target)
 {
-	if (!target_desc) {
-		LOG_ERROR("Unable to Generate Target Description");
-		return ERROR_FAIL;
+	struct reg **reg_list = NULL;
+	int reg_list_size;
+	uint32_t signature;
+
+	if (smp_reg_list_noread(target, &reg_list, &reg_list_size, REG_CLASS_ALL) != ERROR_OK)
+		return 0;
+
+	signature = reg_list_size;
+	for (int i = 0; i < reg_list_size; i++) {
+		const struct reg *reg = reg_list[i];
+
+		signature = signature * 31 + reg->number;
+		signature = signature * 31 + reg->size;
+		signature = signature * 31 + (reg->exist ? 1 : 0);
+		for (const char *c = reg->name; c && *c; c++)
+			signature = signature * 31 + *c;
 	}
 
-	char *tdesc = target_desc->tdesc;
-	uint32_t tdesc_length = target_desc->tdesc_length;
+	free(reg_list);
+	return signature;
+}
 
-	if (!tdesc) {
+static int gdb_get_target_description_chunk(struct target *target, struct gdb_service *gdb_service,
+		char **chunk, int32_t offset, uint32_t length)
+{
+	/* gdb starts every transfer at offset 0, check there that the cached
+	 * description still matches the register layout */
+	uint32_t layout = 0;
+	if (offset == 0)
+		layout = gdb_reg_layout_signature(target);
+	if (gdb_service->tdesc && offset == 0 && layout != gdb_service->tdesc_layout) {
+		LOG_DEBUG("register layout changed, regenerating target description");
+		free(gdb_service->tdesc);
+		gdb_service->tdesc = NULL;
+		gdb_service->tdesc_length = 0;
+	}
+
+	if (!gdb_service->tdesc) {
+		char *tdesc;
+		int64_t start = timeval_ms();
 		int retval = gdb_generate_target_description(target, &tdesc);
 		if (retval != ERROR_OK) {
 			LOG_ERROR("Unable to Generate Target Description");
 			return ERROR_FAIL;
 		}
 
-		tdesc_length = strlen(tdesc);
+		gdb_service->tdesc = tdesc;
+		gdb_service->tdesc_length = strlen(tdesc);
+		gdb_service->tdesc_layout = offset == 0 ? layout : gdb_reg_layout_signature(target);
+		LOG_DEBUG("generated target description for %s: %" PRIu32 " bytes in %" PRId64 " ms",
+				target_name(target), gdb_service->tdesc_length, timeval_ms() - start);
 	}
 
+	char *tdesc = gdb_service->tdesc;
+	uint32_t tdesc_length = gdb_service->tdesc_length;
+
+	if ((uint32_t)offset > tdesc_length)
+		offset = tdesc_length;
+
 	char transfer_type;
 
 	if (length < (tdesc_length - offset))
@@ -2588,16 +2732,8 @@ static int gdb_get_target_description_chunk(struct target *target, struct target
 	} else {
 		strncpy((*chunk) + 1, tdesc + offset, tdesc_length - offset);
 		(*chunk)[1 + (tdesc_length - offset)] = '\0';
-
-		/* After gdb-server sends out last chunk, invalidate tdesc. */
-		free(tdesc);
-		tdesc = NULL;
-		tdesc_length = 0;
 	}
 
-	target_desc->tdesc = tdesc;
-	target_desc->tdesc_length = tdesc_length;
-
 	return ERROR_OK;
 }
 
@@ -2887,7 +3023,7 @@ static int gdb_query_packet(struct connection *connection,
 			&buffer,
 			&pos,
 			&size,
-			"PacketSize=%x;qXfer:memory-map:read%c;qXfer:features:read%c;qXfer:threads:read+;QStartNoAckMode+;vContSupported+",
+			"PacketSize=%x;qXfer:memory-map:read%c;qXfer:features:read%c;qXfer:threads:read+;QStartNoAckMode+;QNonStop+;vContSupported+",
 			GDB_BUFFER_SIZE,
 			((gdb_use_memory_map == 1) && (flash_get_bank_count() > 0)) ? '+' : '-',
 			(gdb_target_desc_supported == 1) ? '+' : '-');
@@ -2924,7 +3060,7 @@ static int gdb_query_packet(struct connection *connection,
 		 * there are *more* chunks to transfer. 'l' for it is the *last*
 		 * chunk of target description.
 		 */
-		retval = gdb_get_target_description_chunk(target, &gdb_connection->target_desc,
+		retval = gdb_get_target_description_chunk(target, connection->service->priv,
 				&xml, offset, length);
 		if (retval != ERROR_OK) {
 			gdb_error(connection, retval);
@@ -2970,6 +3106,11 @@ static int gdb_query_packet(struct connection *connection,
 		gdb_connection->noack_mode = 1;
 		gdb_put_packet(connection, "OK", 2);
 		return ERROR_OK;
+	} else if (strncmp(packet, "QNonStop:", 9) == 0) {
+		gdb_connection->non_stop = (packet[9] == '1');
+		LOG_DEBUG("gdb %s non-stop mode", gdb_connection->non_stop ? "enabled" : "disabled");
+		gdb_put_packet(connection, "OK", 2);
+		return ERROR_OK;
 	} else if (target->type->gdb_query_custom) {
 		char *buffer = NULL;
 		int ret = target->type->gdb_query_custom(target, packet, &buffer);
@@ -2993,7 +3134,7 @@ static bool gdb_handle_vcont_packet(struct connection *connection, const char *p
 	if (parse[0] == '?') {
 		if (target->type->step) {
 			/* gdb doesn't accept c without C and s without S */
-			gdb_put_packet(connection, "vCont;c;C;s;S", 13);
+			gdb_put_packet(connection, "vCont;c;C;s;S;t", 15);
 			return true;
 		}
 		return false;
@@ -3003,11 +3144,40 @@ static bool gdb_handle_vcont_packet(struct connection *connection, const char *p
 		++parse;
 	}
 
+	/* stop request, only meaningful in non-stop mode */
+	if (parse[0] == 't') {
+		if (!gdb_connection->non_stop)
+			return false;
+
+		gdb_put_packet(connection, "OK", 2);
+
+		/* an already stopped target gets no new stop notification */
+		if (target->state != TARGET_RUNNING)
+			return true;
+
+		struct target *t = target;
+		if (target->rtos)
+			target->rtos->gdb_target_for_threadid(connection, target->rtos->current_threadid, &t);
+
+		LOG_DEBUG("target %s stop request", target_name(t));
+		gdb_connection->stop_requested = true;
+		retval = target_halt(t);
+		if (retval == ERROR_OK)
+			retval = target_poll(t);
+		if (retval != ERROR_OK)
+			target_call_event_callbacks(target, TARGET_EVENT_GDB_HALT);
+		return true;
+	}
+
 	/* simple case, a continue packet */
 	if (parse[0] == 'c') {
 		gdb_running_type = 'c';
 		LOG_DEBUG("target %s continue", target_name(target));
-		gdb_connection->output_flag = GDB_OUTPUT_ALL;
+		/* 'O' packets are not allowed in non-stop mode */
+		if (gdb_connection->non_stop)
+			gdb_put_packet(connection, "OK", 2);
+		else
+			gdb_connection->output_flag = GDB_OUTPUT_ALL;
 		retval = target_resume(target, 1, 0, 0, 0);
 		if (retval == ERROR_TARGET_NOT_HALTED)
 			LOG_INFO("target %s was not halted when resume was requested", target_name(target));
@@ -3095,7 +3265,10 @@ static bool gdb_handle_vcont_packet(struct connection *connection, const char *p
 		}
 
 		LOG_DEBUG("target %s single-step thread %"PRIx64, target_name(ct), thread_id);
-		gdb_connection->output_flag = GDB_OUTPUT_ALL;
+		if (gdb_connection->non_stop)
+			gdb_put_packet(connection, "OK", 2);
+		else
+			gdb_connection->output_flag = GDB_OUTPUT_ALL;
 		target_call_event_callbacks(ct, TARGET_EVENT_GDB_START);
 
 		/*
@@ -3115,7 +3288,7 @@ static bool gdb_handle_vcont_packet(struct connection *connection, const char *p
 			sig_reply_len = snprintf(sig_reply, sizeof(sig_reply),
 									"T05thread:%016"PRIx64";", thread_id);
 
-			gdb_put_packet(connection, sig_reply, sig_reply_len);
+			gdb_put_stop_reply(connection, sig_reply, sig_reply_len);
 			gdb_connection->output_flag = GDB_OUTPUT_NO;
 
 			return true;
@@ -3268,6 +3441,13 @@ static int gdb_v_packet(struct connection *connection,
 		return ERROR_OK;
 	}
 
+	if (strncmp(packet, "vStopped", 8) == 0) {
+		/* a single stop is tracked per connection and it was carried by
+		 * the %Stop notification, so the queue is always drained here */
+		gdb_put_packet(connection, "OK", 2);
+		return ERROR_OK;
+	}
+
 	if (strncmp(packet, "vRun", 4) == 0) {
 		bool handled;
 
@@ -3488,7 +3668,7 @@ static void gdb_sig_halted(struct connection *connection)
 {
 	char sig_reply[4];
 	snprintf(sig_reply, 4, "T%2.2x", 2);
-	gdb_put_packet(connection, sig_reply, 3);
+	gdb_put_stop_reply(connection, sig_reply, 3);
 }
 
 static int gdb_input_inner(struct connection *connection)
@@ -3579,7 +3759,8 @@ static int gdb_input_inner(struct connection *connection)
 				case 's':
 				{
 					gdb_thread_packet(connection, packet, packet_size);
-					gdb_con->output_flag = GDB_OUTPUT_ALL;
+					if (!gdb_con->non_stop)
+						gdb_con->output_flag = GDB_OUTPUT_ALL;
 
 					if (gdb_con->mem_write_error) {
 						LOG_ERROR("Memory write failure!");
@@ -3758,6 +3939,11 @@ static void gdb_keep_client_alive(struct connection *connection)
 		return;
 	}
 
+	/* gdb keeps sending requests in non-stop mode, an 'O' packet would
+	 * be taken as the reply to one of them */
+	if (gdb_con->non_stop)
+		return;
+
 	switch (gdb_con->output_flag) {
 	case GDB_OUTPUT_NO:
 		/* no need for keep-alive */
@@ -3794,6 +3980,12 @@ static int gdb_target_start(struct target *target, const char *port)
 	gdb_service->target = target;
 	gdb_service->core[0] = -1;
 	gdb_service->core[1] = -1;
+	gdb_service->connection_count = 0;
+	gdb_service->tdesc = NULL;
+	gdb_service->tdesc_length = 0;
+	gdb_service->tdesc_layout = 0;
+	gdb_service->memory_map = NULL;
+	gdb_service->memory_map_length = 0;
 	target->gdb_service = gdb_service;
 
 	ret = add_service(&gdb_service_driver, port, target->gdb_max_connections, gdb_service);
@@ -17,6 +17,18 @@
 #define TCL_LINE_INITIAL		(4*1024)
 #define TCL_LINE_MAX			(4*1024*1024)
 
+/* Framed mode, enabled per connection with 'tcl_framed on'.
+ * Request:  u32 payload length, u32 request id, command text
+ *           [, null byte, binary data bound to $tcl_frame_data]
+ * Response: u32 payload length, u32 request id, u32 status, result bytes
+ * All header fields are little endian. Frames with request id 0 are sent
+ * by the server on its own, the status field then names the channel. */
+#define TCL_FRAME_REQUEST_HEADER	8
+#define TCL_FRAME_REPLY_HEADER		12
+#define TCL_FRAME_NOTIFICATION		1
+#define TCL_FRAME_TRACE			2
+#define TCL_FRAME_DATA_VAR		"tcl_frame_data"
+
 struct tcl_connection {
 	int tc_linedrop;
 	int tc_lineoffset;
@@ -26,6 +38,8 @@ struct tcl_connection {
 	enum target_state tc_laststate;
 	bool tc_notify;
 	bool tc_trace;
+	bool tc_framed;
+	int tc_frame_size;	/* header plus payload of the frame being received */
 };
 
 static char *tcl_port;
@@ -35,6 +49,20 @@ static int tcl_new_connection(struct connection *connection);
 static int tcl_input(struct connection *connection);
 static int tcl_output(struct connection *connection, const void *buf, ssize_t len);
 static int tcl_closed(struct connection *connection);
+static int tcl_output_frame(struct connection *connection, uint32_t id,
+		uint32_t status, const void *data, size_t len);
+
+static int tcl_output_notification(struct connection *connection, const char *msg)
+{
+	struct tcl_connection *tclc = connection->priv;
+	char buf[256];
+
+	if (tclc->tc_framed)
+		return tcl_output_frame(connection, 0, TCL_FRAME_NOTIFICATION, msg, strlen(msg));
+
+	snprintf(buf, sizeof(buf), "%s\r\n\x1a", msg);
+	return tcl_output(connection, buf, strlen(buf));
+}
 
 static int tcl_target_callback_event_handler(struct target *target,
 		enum target_event event, void *priv)
@@ -46,15 +74,15 @@ static int tcl_target_callback_event_handler(struct target *target,
 	tclc = connection->priv;
 
 	if (tclc->tc_notify) {
-		snprintf(buf, sizeof(buf), "type target_event event %s\r\n\x1a", target_event_name(event));
-		tcl_output(connection, buf, strlen(buf));
+		snprintf(buf, sizeof(buf), "type target_event event %s", target_event_name(event));
+		tcl_output_notification(connection, buf);
 	}
 
 	if (tclc->tc_laststate != target->state) {
 		tclc->tc_laststate = target->state;
 		if (tclc->tc_notify) {
-			snprintf(buf, sizeof(buf), "type target_state state %s\r\n\x1a", target_state_name(target));
-			tcl_output(connection, buf, strlen(buf));
+			snprintf(buf, sizeof(buf), "type target_state state %s", target_state_name(target));
+			tcl_output_notification(connection, buf);
 		}
 	}
 
@@ -71,8 +99,8 @@ static int tcl_target_callback_reset_handler(struct target *target,
 	tclc = connection->priv;
 
 	if (tclc->tc_notify) {
-		snprintf(buf, sizeof(buf), "type target_reset mode %s\r\n\x1a", target_reset_mode_name(reset_mode));
-		tcl_output(connection, buf, strlen(buf));
+		snprintf(buf, sizeof(buf), "type target_reset mode %s", target_reset_mode_name(reset_mode));
+		tcl_output_notification(connection, buf);
 	}
 
 	return ERROR_OK;
@@ -91,7 +119,10 @@ static int tcl_target_callback_trace_handler(struct target *target,
 
 	tclc = connection->priv;
 
-	if (tclc->tc_trace) {
+	/* framed connections get the raw trace data */
+	if (tclc->tc_trace && tclc->tc_framed) {
+		tcl_output_frame(connection, 0, TCL_FRAME_TRACE, data, len);
+	} else if (tclc->tc_trace) {
 		hex = malloc(hex_len);
 		buf = malloc(max_len);
 		hexify(hex, data, len, hex_len);
@@ -128,6 +159,21 @@ int tcl_output(struct connection *connection, const void *data, ssize_t len)
 	return ERROR_SERVER_REMOTE_CLOSED;
 }
 
+static int tcl_output_frame(struct connection *connection, uint32_t id,
+		uint32_t status, const void *data, size_t len)
+{
+	uint8_t header[TCL_FRAME_REPLY_HEADER];
+
+	h_u32_to_le(header, len);
+	h_u32_to_le(header + 4, id);
+	h_u32_to_le(header + 8, status);
+
+	int retval = tcl_output(connection, header, sizeof(header));
+	if (retval != ERROR_OK || !len)
+		return retval;
+	return tcl_output(connection, data, len);
+}
+
 /* connections */
 static int tcl_new_connection(struct connection *connection)
 {
@@ -160,6 +206,94 @@ static int tcl_new_connection(struct connection *connection)
 	return ERROR_OK;
 }
 
+/* Consume framed input. Every complete frame is executed right away, so a
+ * client can keep many requests in flight and match the replies by id.
+ * Returns after all data is consumed, or after a frame turned framing off. */
+static int tcl_input_framed(struct connection *connection,
+		const unsigned char *data, size_t len, size_t *used)
+{
+	Jim_Interp *interp = (Jim_Interp *)connection->cmd_ctx->interp;
+	struct tcl_connection *tclc = connection->priv;
+	size_t n;
+	int retval;
+
+	*used = 0;
+	while (tclc->tc_framed) {
+		if (tclc->tc_lineoffset < TCL_FRAME_REQUEST_HEADER) {
+			if (*used == len)
+				break;
+			n = MIN(len - *used, (size_t)(TCL_FRAME_REQUEST_HEADER - tclc->tc_lineoffset));
+			memcpy(tclc->tc_line + tclc->tc_lineoffset, data + *used, n);
+			tclc->tc_lineoffset += n;
+			*used += n;
+			if (tclc->tc_lineoffset < TCL_FRAME_REQUEST_HEADER)
+				break;
+
+			uint32_t payload = le_to_h_u32((uint8_t *)tclc->tc_line);
+			if (payload > TCL_LINE_MAX - TCL_FRAME_REQUEST_HEADER - 1) {
+				LOG_ERROR("tcl: frame of %" PRIu32 " bytes is too long", payload);
+				return ERROR_SERVER_REMOTE_CLOSED;
+			}
+			tclc->tc_frame_size = TCL_FRAME_REQUEST_HEADER + payload;
+
+			/* room for the frame and a terminating null */
+			if (tclc->tc_frame_size + 1 > tclc->tc_line_size) {
+				char *tc_line_new = realloc(tclc->tc_line, tclc->tc_frame_size + 1);
+				if (!tc_line_new) {
+					LOG_ERROR("tcl: out of memory for a %" PRIu32 " bytes frame", payload);
+					return ERROR_SERVER_REMOTE_CLOSED;
+				}
+				tclc->tc_line = tc_line_new;
+				tclc->tc_line_size = tclc->tc_frame_size + 1;
+			}
+		}
+
+		if (tclc->tc_lineoffset < tclc->tc_frame_size) {
+			if (*used == len)
+				break;
+			n = MIN(len - *used, (size_t)(tclc->tc_frame_size - tclc->tc_lineoffset));
+			memcpy(tclc->tc_line + tclc->tc_lineoffset, data + *used, n);
+			tclc->tc_lineoffset += n;
+			*used += n;
+			if (tclc->tc_lineoffset < tclc->tc_frame_size)
+				break;
+		}
+
+		uint32_t id = le_to_h_u32((uint8_t *)tclc->tc_line + 4);
+		char *cmd = tclc->tc_line + TCL_FRAME_REQUEST_HEADER;
+		int cmd_len = strlen(cmd);
+		int data_len = tclc->tc_frame_size - TCL_FRAME_REQUEST_HEADER - cmd_len - 1;
+		const char *result;
+		int reslen;
+
+		tclc->tc_line[tclc->tc_frame_size] = '\0';
+		tclc->tc_lineoffset = 0;
+
+		/* the script text ends at the first null byte, any bytes after it
+		 * are handed to the script unmodified in a variable */
+		Jim_Obj *data_var = NULL;
+		if (data_len >= 0) {
+			data_var = Jim_NewStringObj(interp, "::" TCL_FRAME_DATA_VAR, -1);
+			Jim_IncrRefCount(data_var);
+			Jim_SetVariable(interp, data_var,
+				Jim_NewStringObj(interp, cmd + cmd_len + 1, data_len));
+		}
+
+		retval = command_run_line(connection->cmd_ctx, cmd);
+		result = Jim_GetString(Jim_GetResult(interp), &reslen);
+		retval = tcl_output_frame(connection, id, retval, result, reslen);
+
+		if (data_var) {
+			Jim_UnsetVariable(interp, data_var, JIM_NONE);
+			Jim_DecrRefCount(interp, data_var);
+		}
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	return ERROR_OK;
+}
+
 static int tcl_input(struct connection *connection)
 {
 	Jim_Interp *interp = (Jim_Interp *)connection->cmd_ctx->interp;
@@ -186,6 +320,16 @@ static int tcl_input(struct connection *connection)
 
 	/* push as much data into the line as possible */
 	for (i = 0; i < rlen; i++) {
+		if (tclc->tc_framed) {
+			size_t used;
+			retval = tcl_input_framed(connection, in + i, rlen - i, &used);
+			if (retval != ERROR_OK)
+				return retval;
+			/* framing was switched off, continue with plain lines */
+			i += used - 1;
+			continue;
+		}
+
 		/* buffer the data */
 		tclc->tc_line[tclc->tc_lineoffset] = in[i];
 		if (tclc->tc_lineoffset + 1 < tclc->tc_line_size) {
@@ -306,6 +450,23 @@ COMMAND_HANDLER(handle_tcl_notifications_command)
 	}
 }
 
+COMMAND_HANDLER(handle_tcl_framed_command)
+{
+	struct connection *connection = NULL;
+	struct tcl_connection *tclc = NULL;
+
+	if (CMD_CTX->output_handler_priv)
+		connection = CMD_CTX->output_handler_priv;
+
+	if (!connection || strcmp(connection->service->name, "tcl")) {
+		LOG_ERROR("%s: can only be called from the tcl server", CMD_NAME);
+		return ERROR_COMMAND_SYNTAX_ERROR;
+	}
+
+	tclc = connection->priv;
+	return CALL_COMMAND_HANDLER(handle_command_parse_bool, &tclc->tc_framed, "Framed RPC protocol ");
+}
+
 COMMAND_HANDLER(handle_tcl_trace_command)
 {
 	struct connection *connection = NULL;
@@ -340,6 +501,13 @@ static const struct command_registration tcl_command_handlers[] = {
 		.help = "Target Notification output",
 		.usage = "[on|off]",
 	},
+	{
+		.name = "tcl_framed",
+		.handler = handle_tcl_framed_command,
+		.mode = COMMAND_EXEC,
+		.help = "Switch this connection to length-prefixed frames",
+		.usage = "[on|off]",
+	},
 	{
 		.name = "tcl_trace",
 		.handler = handle_tcl_trace_command,
@@ -35,19 +35,50 @@ static char *negotiate =
  * we write to it, we will fail. Subsequent write operations will
  * succeed. Shudder!
  */
-static int telnet_write(struct connection *connection, const void *data,
-	int len)
+static int telnet_flush(struct connection *connection)
 {
 	struct telnet_connection *t_con = connection->priv;
+	size_t len = t_con->output_size;
+
+	t_con->output_size = 0;
 	if (t_con->closed)
 		return ERROR_SERVER_REMOTE_CLOSED;
 
-	if (connection_write(connection, data, len) == len)
+	if (!len || connection_write(connection, t_con->output, len) == (int)len)
 		return ERROR_OK;
 	t_con->closed = true;
 	return ERROR_SERVER_REMOTE_CLOSED;
 }
 
+/* Output is collected per connection and sent with a single write at the
+ * end of each input, log message or command output, instead of a write
+ * for each piece of a line, prompt and redraw.
+ */
+static int telnet_write(struct connection *connection, const void *data,
+	int len)
+{
+	struct telnet_connection *t_con = connection->priv;
+	if (t_con->closed)
+		return ERROR_SERVER_REMOTE_CLOSED;
+
+	if (t_con->output_size + len > sizeof(t_con->output)) {
+		int retval = telnet_flush(connection);
+		if (retval != ERROR_OK)
+			return retval;
+	}
+
+	if ((size_t)len > sizeof(t_con->output)) {
+		if (connection_write(connection, data, len) == len)
+			return ERROR_OK;
+		t_con->closed = true;
+		return ERROR_SERVER_REMOTE_CLOSED;
+	}
+
+	memcpy(t_con->output + t_con->output_size, data, len);
+	t_con->output_size += len;
+	return ERROR_OK;
+}
+
 /* output an audible bell */
 static int telnet_bell(struct connection *connection)
 {
@@ -90,7 +121,8 @@ static int telnet_output(struct command_context *cmd_ctx, const char *line)
 {
 	struct connection *connection = cmd_ctx->output_handler_priv;
 
-	return telnet_outputline(connection, line);
+	telnet_outputline(connection, line);
+	return telnet_flush(connection);
 }
 
 static void telnet_log_callback(void *priv, const char *file, unsigned line,
@@ -104,6 +136,7 @@ static void telnet_log_callback(void *priv, const char *file, unsigned line,
 	/* If the prompt is not visible, simply output the message. */
 	if (!t_con->prompt_visible) {
 		telnet_outputline(connection, string);
+		telnet_flush(connection);
 		return;
 	}
 
@@ -129,6 +162,8 @@ static void telnet_log_callback(void *priv, const char *file, unsigned line,
 
 	for (i = t_con->line_cursor; i < t_con->line_size; i++)
 		telnet_write(connection, "\b", 1);
+
+	telnet_flush(connection);
 }
 
 static void telnet_load_history(struct telnet_connection *t_con)
@@ -241,6 +276,7 @@ static int telnet_new_connection(struct connection *connection)
 	/* the prompt is always placed at the line beginning */
 	telnet_write(connection, "\r", 1);
 	telnet_prompt(connection);
+	telnet_flush(connection);
 
 	telnet_load_history(telnet_connection);
 
@@ -513,6 +549,9 @@ static int telnet_exec_line(struct connection *connection)
 	if (strcmp(t_con->line, "shutdown") == 0)
 		telnet_save_history(t_con);
 
+	/* show the line break before a possibly long running command */
+	telnet_flush(connection);
+
 	retval = command_run_line(command_context, t_con->line);
 
 	t_con->line_cursor = 0;
@@ -900,7 +939,7 @@ static int telnet_input(struct connection *connection)
 		buf_p++;
 	}
 
-	return ERROR_OK;
+	return telnet_flush(connection);
 }
 
 static int telnet_connection_closed(struct connection *connection)
@@ -17,6 +17,7 @@
 #include <server/server.h>
 
 #define TELNET_BUFFER_SIZE (10*1024)
+#define TELNET_OUTPUT_BUFFER_SIZE (4*1024)
 
 #define TELNET_LINE_HISTORY_SIZE (128)
 #define TELNET_LINE_MAX_SIZE (10*256)
@@ -45,6 +46,9 @@ struct telnet_connection {
 	size_t next_history;
 	size_t current_history;
 	bool closed;
+	/* output collected by telnet_write(), sent by telnet_flush() */
+	char output[TELNET_OUTPUT_BUFFER_SIZE];
+	size_t output_size;
 };
 
 struct telnet_service {
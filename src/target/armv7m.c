@@ -349,6 +349,18 @@ static int armv7m_read_core_reg(struct target *target, struct reg *r,
 	} else {
 		assert(r->size == 32 || r->size == 64);
 
+		if (num >= ARMV7M_FPU_FIRST_REG && num <= ARMV7M_FPU_LAST_REG
+				&& armv7m->load_fpu_regs) {
+			/* FP registers are not read on debug entry, fetch the whole
+			 * bank now. Other dirty FP registers are left untouched */
+			r->valid = false;
+			retval = armv7m->load_fpu_regs(target);
+			if (retval != ERROR_OK)
+				return retval;
+			if (r->valid)
+				return ERROR_OK;
+		}
+
 		struct arm_reg *armv7m_core_reg = r->arch_info;
 		uint32_t regsel = armv7m_map_id_to_regsel(armv7m_core_reg->num);
 
@@ -240,6 +240,8 @@ struct armv7m_common {
 	/* Direct processor core register read and writes */
 	int (*load_core_reg_u32)(struct target *target, uint32_t regsel, uint32_t *value);
 	int (*store_core_reg_u32)(struct target *target, uint32_t regsel, uint32_t value);
+	/* Optional: load all FP registers at once on the first access after halt */
+	int (*load_fpu_regs)(struct target *target);
 
 	int (*examine_debug_reason)(struct target *target);
 	int (*post_debug_entry)(struct target *target);
@@ -226,12 +226,14 @@ static int cortex_m_slow_read_all_regs(struct target *target)
 {
 	struct cortex_m_common *cortex_m = target_to_cm(target);
 	struct armv7m_common *armv7m = target_to_armv7m(target);
-	const unsigned int num_regs = armv7m->arm.core_cache->num_regs;
+	const unsigned int num_regs = MIN(armv7m->arm.core_cache->num_regs,
+									  ARMV7M_FPU_FIRST_REG);
 
 	/* Opportunistically restore fast read, it'll revert to slow
 	 * if any register needed polling in cortex_m_load_core_reg_u32(). */
 	cortex_m->slow_register_read = false;
 
+	/* FP registers are not read here, they are loaded on demand */
 	for (unsigned int reg_id = 0; reg_id < num_regs; reg_id++) {
 		struct reg *r = &armv7m->arm.core_cache->reg_list[reg_id];
 		if (r->exist) {
@@ -264,7 +266,12 @@ static int cortex_m_queue_reg_read(struct target *target, uint32_t regsel,
 	return mem_ap_read_u32(armv7m->debug_ap, DCB_DCRDR, reg_value);
 }
 
-static int cortex_m_fast_read_all_regs(struct target *target)
+/** Read registers with ids from @a first_reg up to (not including)
+ * @a end_reg in one DAP transaction. Registers already valid in the cache
+ * are skipped so a batch read never overwrites dirty values.
+ */
+static int cortex_m_fast_read_regs(struct target *target,
+		unsigned int first_reg, unsigned int end_reg)
 {
 	struct cortex_m_common *cortex_m = target_to_cm(target);
 	struct armv7m_common *armv7m = target_to_armv7m(target);
@@ -279,7 +286,7 @@ static int cortex_m_fast_read_all_regs(struct target *target)
 			return retval;
 	}
 
-	const unsigned int num_regs = armv7m->arm.core_cache->num_regs;
+	const unsigned int num_regs = MIN(armv7m->arm.core_cache->num_regs, end_reg);
 	const unsigned int n_r32 = ARMV7M_LAST_REG - ARMV7M_CORE_FIRST_REG + 1
 							   + ARMV7M_FPU_LAST_REG - ARMV7M_FPU_FIRST_REG + 1;
 	/* we need one 32-bit word for each register except FP D0..D15, which
@@ -289,10 +296,10 @@ static int cortex_m_fast_read_all_regs(struct target *target)
 
 	unsigned int wi = 0; /* write index to r_vals and dhcsr arrays */
 	unsigned int reg_id; /* register index in the reg_list, ARMV7M_R0... */
-	for (reg_id = 0; reg_id < num_regs; reg_id++) {
+	for (reg_id = first_reg; reg_id < num_regs; reg_id++) {
 		struct reg *r = &armv7m->arm.core_cache->reg_list[reg_id];
-		if (!r->exist)
-			continue;	/* skip non existent registers */
+		if (!r->exist || r->valid)
+			continue;	/* skip non existent and already cached registers */
 
 		if (r->size <= 8) {
 			/* Any 8-bit or shorter register is unpacked from a 32-bit
@@ -352,10 +359,10 @@ static int cortex_m_fast_read_all_regs(struct target *target)
 	LOG_TARGET_DEBUG(target, "read %u 32-bit registers", wi);
 
 	unsigned int ri = 0; /* read index from r_vals array */
-	for (reg_id = 0; reg_id < num_regs; reg_id++) {
+	for (reg_id = first_reg; reg_id < num_regs; reg_id++) {
 		struct reg *r = &armv7m->arm.core_cache->reg_list[reg_id];
-		if (!r->exist)
-			continue;	/* skip non existent registers */
+		if (!r->exist || r->valid)
+			continue;	/* skip non existent and already cached registers */
 
 		r->dirty = false;
 
@@ -388,6 +395,28 @@ static int cortex_m_fast_read_all_regs(struct target *target)
 	return retval;
 }
 
+/** Load the whole FP register bank in one DAP transaction on the first
+ * access to any FP register after halt.
+ */
+static int cortex_m_load_fpu_regs(struct target *target)
+{
+	struct cortex_m_common *cortex_m = target_to_cm(target);
+
+	/* Let the caller poll S_REGRDY register by register */
+	if (cortex_m->slow_register_read)
+		return ERROR_OK;
+
+	int retval = cortex_m_fast_read_regs(target, ARMV7M_FPU_FIRST_REG,
+										 ARMV7M_FPU_LAST_REG + 1);
+	if (retval == ERROR_TIMEOUT_REACHED) {
+		cortex_m->slow_register_read = true;
+		LOG_TARGET_DEBUG(target, "Switched to slow register read");
+		return ERROR_OK;
+	}
+
+	return retval;
+}
+
 static int cortex_m_store_core_reg_u32(struct target *target,
 		uint32_t regsel, uint32_t value)
 {
@@ -830,9 +859,12 @@ static int cortex_m_debug_entry(struct target *target)
 			return retval;
 	}
 
-	/* Load all registers to arm.core_cache */
+	/* Load core registers to arm.core_cache. FP registers stay invalid
+	 * until they are accessed, see cortex_m_load_fpu_regs() */
+	register_cache_invalidate(arm->core_cache);
 	if (!cortex_m->slow_register_read) {
-		retval = cortex_m_fast_read_all_regs(target);
+		retval = cortex_m_fast_read_regs(target, ARMV7M_CORE_FIRST_REG,
+										 ARMV7M_FPU_FIRST_REG);
 		if (retval == ERROR_TIMEOUT_REACHED) {
 			cortex_m->slow_register_read = true;
 			LOG_TARGET_DEBUG(target, "Switched to slow register read");
@@ -2216,6 +2248,9 @@ void cortex_m_deinit_target(struct target *target)
 	free(cortex_m);
 }
 
+/* Number of DWT_PCSR reads queued in one DAP transaction while profiling */
+#define CORTEX_M_PCSR_BATCH 1024
+
 int cortex_m_profiling(struct target *target, uint32_t *samples,
 			      uint32_t max_num_samples, uint32_t *num_samples, uint32_t seconds)
 {
@@ -2250,19 +2285,22 @@ int cortex_m_profiling(struct target *target, uint32_t *samples,
 	}
 
 	uint32_t sample_count = 0;
+	uint32_t discarded = 0;
+	int64_t start_ms = timeval_ms();
 
 	for (;;) {
-		if (armv7m && armv7m->debug_ap) {
-			uint32_t read_count = max_num_samples - sample_count;
-			if (read_count > 1024)
-				read_count = 1024;
+		uint32_t *batch = &samples[sample_count];
+		uint32_t read_count = 1;
 
+		if (armv7m && armv7m->debug_ap) {
+			/* Queue a whole batch of PCSR reads into one DAP transaction */
+			read_count = MIN(max_num_samples - sample_count, CORTEX_M_PCSR_BATCH);
 			retval = mem_ap_read_buf_noincr(armv7m->debug_ap,
-						(void *)&samples[sample_count],
-						4, read_count, DWT_PCSR);
-			sample_count += read_count;
+						(uint8_t *)batch, 4, read_count, DWT_PCSR);
 		} else {
-			target_read_u32(target, DWT_PCSR, &samples[sample_count++]);
+			uint32_t pcsr;
+			retval = target_read_u32(target, DWT_PCSR, &pcsr);
+			h_u32_to_le((uint8_t *)batch, pcsr);
 		}
 
 		if (retval != ERROR_OK) {
@@ -2270,10 +2308,24 @@ int cortex_m_profiling(struct target *target, uint32_t *samples,
 			return retval;
 		}
 
+		/* PCSR reads as 0xffffffff while the core is halted or sampling
+		 * is prohibited. Drop such samples, they would only stretch
+		 * the histogram address range */
+		uint32_t valid = 0;
+		for (uint32_t i = 0; i < read_count; i++) {
+			uint32_t pc = le_to_h_u32((uint8_t *)&batch[i]);
+			if (pc != 0xffffffff)
+				batch[valid++] = pc;
+		}
+		discarded += read_count - valid;
+		sample_count += valid;
 
 		gettimeofday(&now, NULL);
 		if (sample_count >= max_num_samples || timeval_compare(&now, &timeout) > 0) {
-			LOG_TARGET_INFO(target, "Profiling completed. %" PRIu32 " samples.", sample_count);
+			int64_t elapsed_ms = MAX(timeval_ms() - start_ms, 1);
+			int64_t rate = (int64_t)(sample_count + discarded) * 1000 / elapsed_ms;
+			LOG_TARGET_INFO(target, "Profiling completed. %" PRIu32 " samples, %" PRIu32
+				" discarded, %" PRId64 " samples/s", sample_count, discarded, rate);
 			break;
 		}
 	}
@@ -2820,6 +2872,7 @@ static int cortex_m_init_arch_info(struct target *target,
 	armv7m->pre_restore_context = NULL;
 
 	armv7m->load_core_reg_u32 = cortex_m_load_core_reg_u32;
+	armv7m->load_fpu_regs = cortex_m_load_fpu_regs;
 	armv7m->store_core_reg_u32 = cortex_m_store_core_reg_u32;
 
 	target_register_timer_callback(cortex_m_handle_target_request, 1,
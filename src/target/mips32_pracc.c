@@ -1161,19 +1161,36 @@ int mips32_pracc_fastdata_xfer(struct mips_ejtag *ejtag_info, struct working_are
 	if (source->size < MIPS32_FASTDATA_HANDLER_SIZE)
 		return ERROR_TARGET_RESOURCE_NOT_AVAILABLE;
 
+	/* If the working area has room for both, the read and the write handler
+	 * get their own slot and stay resident when the direction changes */
+	target_addr_t handler_addr = source->address;
+	uint32_t handler_bit = write_t ? MIPS32_FASTDATA_WRITE_LOADED : MIPS32_FASTDATA_READ_LOADED;
+	bool dual_slot = source->size >= 2 * MIPS32_FASTDATA_HANDLER_SIZE;
+	if (dual_slot && !write_t)
+		handler_addr += MIPS32_FASTDATA_HANDLER_SIZE;
+
 	pracc_swap16_array(ejtag_info, handler_code, ARRAY_SIZE(handler_code));
 		/* write program into RAM */
-	if (write_t != ejtag_info->fast_access_save) {
-		mips32_pracc_write_mem(ejtag_info, source->address, 4, ARRAY_SIZE(handler_code), handler_code);
-		/* save previous operation to speed to any consecutive read/writes */
-		ejtag_info->fast_access_save = write_t;
+	if (!(ejtag_info->fastdata_loaded & handler_bit)) {
+		int retval = mips32_pracc_write_mem(ejtag_info, handler_addr, 4,
+				ARRAY_SIZE(handler_code), handler_code);
+		if (retval != ERROR_OK) {
+			ejtag_info->fastdata_loaded = 0;
+			return retval;
+		}
+		/* keep the handler to speed up any consecutive read/writes */
+		if (dual_slot)
+			ejtag_info->fastdata_loaded |= handler_bit;
+		else
+			ejtag_info->fastdata_loaded = handler_bit;
 	}
 
-	LOG_DEBUG("%s using 0x%.8" TARGET_PRIxADDR " for write handler", __func__, source->address);
+	LOG_DEBUG("%s using 0x%.8" TARGET_PRIxADDR " for %s handler", __func__, handler_addr,
+			write_t ? "write" : "read");
 
 	uint32_t jmp_code[] = {
-		MIPS32_LUI(isa, 15, UPPER16(source->address)),			/* load addr of jump in $15 */
-		MIPS32_ORI(isa, 15, 15, LOWER16(source->address) | isa),	/* isa bit for JR instr */
+		MIPS32_LUI(isa, 15, UPPER16(handler_addr)),			/* load addr of jump in $15 */
+		MIPS32_ORI(isa, 15, 15, LOWER16(handler_addr) | isa),	/* isa bit for JR instr */
 		mips32_cpu_support_hazard_barrier(ejtag_info)
 			? MIPS32_JRHB(isa, 15)
 			: MIPS32_JR(isa, 15),	/* jump to ram program */
@@ -1240,5 +1257,9 @@ int mips32_pracc_fastdata_xfer(struct mips_ejtag *ejtag_info, struct working_are
 	if (ejtag_info->pa_addr != MIPS32_PRACC_TEXT)
 		LOG_ERROR("mini program did not return to start");
 
+	/* Reads go through the caches, only written data needs to be synced */
+	if (!write_t)
+		return ERROR_OK;
+
 	return mips32_pracc_fastdata_xfer_synchronize_cache(ejtag_info, addr, 4, count);
 }
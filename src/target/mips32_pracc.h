@@ -28,6 +28,10 @@
 #define PRACC_OUT_OFFSET			(MIPS32_PRACC_PARAM_OUT - MIPS32_PRACC_BASE_ADDR)
 
 #define MIPS32_FASTDATA_HANDLER_SIZE		0x80
+
+/* bits of mips_ejtag.fastdata_loaded */
+#define MIPS32_FASTDATA_READ_LOADED		BIT(0)
+#define MIPS32_FASTDATA_WRITE_LOADED	BIT(1)
 #define UPPER16(addr)				((addr) >> 16)
 #define LOWER16(addr)				((addr) & 0xFFFF)
 #define NEG16(v)				(((~(v)) + 1) & 0xFFFF)
@@ -405,6 +405,7 @@ int mips_ejtag_init(struct mips_ejtag *ejtag_info)
 		ejtag_info->ejtag_ctrl |= EJTAG_CTRL_ROCC | EJTAG_CTRL_SETDEV;
 
 	ejtag_info->fast_access_save = -1;
+	ejtag_info->fastdata_loaded = 0;
 
 	mips_ejtag_init_mmr(ejtag_info);
 
@@ -209,6 +209,7 @@ struct mips_ejtag {
 	uint32_t prid;
 	uint32_t ejtag_ctrl;
 	int fast_access_save;
+	uint32_t fastdata_loaded;	/* MIPS32 fastdata handlers resident in the working area */
 	uint32_t config_regs;	/* number of config registers read */
 	uint32_t config[4];	/* cp0 config to config3 */
 
@@ -1193,6 +1193,34 @@ static int mips_m4k_examine(struct target *target)
 	return mips32_examine(target);
 }
 
+/* Get memory for the fastdata read and write handlers.
+ * We preserve this area between calls, so the handlers are uploaded only
+ * once, this will be released/nulled by the system when the target is
+ * resumed or reset */
+static int mips_m4k_alloc_fast_data_area(struct target *target)
+{
+	struct mips32_common *mips32 = target_to_mips32(target);
+	struct mips_ejtag *ejtag_info = &mips32->ejtag_info;
+
+	/* Room for both handlers, fall back to one shared slot */
+	int retval = target_alloc_working_area_try(target,
+			2 * MIPS32_FASTDATA_HANDLER_SIZE,
+			&mips32->fast_data_area);
+	if (retval != ERROR_OK)
+		retval = target_alloc_working_area(target,
+				MIPS32_FASTDATA_HANDLER_SIZE,
+				&mips32->fast_data_area);
+	if (retval != ERROR_OK) {
+		LOG_ERROR("No working area available");
+		return retval;
+	}
+
+	/* reset fastadata state so the algo get reloaded */
+	ejtag_info->fastdata_loaded = 0;
+
+	return ERROR_OK;
+}
+
 static int mips_m4k_bulk_write_memory(struct target *target, target_addr_t address,
 		uint32_t count, const uint8_t *buffer)
 {
@@ -1210,29 +1238,18 @@ static int mips_m4k_bulk_write_memory(struct target *target, target_addr_t addre
 		return ERROR_TARGET_UNALIGNED_ACCESS;
 
 	if (!mips32->fast_data_area) {
-		/* Get memory for block write handler
-		 * we preserve this area between calls and gain a speed increase
-		 * of about 3kb/sec when writing flash
-		 * this will be released/nulled by the system when the target is resumed or reset */
-		retval = target_alloc_working_area(target,
-				MIPS32_FASTDATA_HANDLER_SIZE,
-				&mips32->fast_data_area);
-		if (retval != ERROR_OK) {
-			LOG_ERROR("No working area available");
+		retval = mips_m4k_alloc_fast_data_area(target);
+		if (retval != ERROR_OK)
 			return retval;
-		}
-
-		/* reset fastadata state so the algo get reloaded */
-		ejtag_info->fast_access_save = -1;
 	}
 
 	fast_data_area = mips32->fast_data_area;
 
 	if (address < (fast_data_area->address + fast_data_area->size) &&
-			fast_data_area->address < (address + count)) {
+			fast_data_area->address < (address + count * 4)) {
 		LOG_ERROR("fast_data (" TARGET_ADDR_FMT ") is within write area "
 			  "(" TARGET_ADDR_FMT "-" TARGET_ADDR_FMT ").",
-			  fast_data_area->address, address, address + count);
+			  fast_data_area->address, address, address + count * 4);
 		LOG_ERROR("Change work-area-phys or load_image address!");
 		return ERROR_FAIL;
 	}
@@ -1276,29 +1293,18 @@ static int mips_m4k_bulk_read_memory(struct target *target, target_addr_t addres
 		return ERROR_TARGET_UNALIGNED_ACCESS;
 
 	if (!mips32->fast_data_area) {
-		/* Get memory for block read handler
-		 * we preserve this area between calls and gain a speed increase
-		 * of about 3kb/sec when reading flash
-		 * this will be released/nulled by the system when the target is resumed or reset */
-		retval = target_alloc_working_area(target,
-				MIPS32_FASTDATA_HANDLER_SIZE,
-				&mips32->fast_data_area);
-		if (retval != ERROR_OK) {
-			LOG_ERROR("No working area available");
+		retval = mips_m4k_alloc_fast_data_area(target);
+		if (retval != ERROR_OK)
 			return retval;
-		}
-
-		/* reset fastadata state so the algo get reloaded */
-		ejtag_info->fast_access_save = -1;
 	}
 
 	fast_data_area = mips32->fast_data_area;
 
 	if (address < (fast_data_area->address + fast_data_area->size) &&
-			fast_data_area->address < (address + count)) {
+			fast_data_area->address < (address + count * 4)) {
 		LOG_ERROR("fast_data (" TARGET_ADDR_FMT ") is within read area "
 				"(" TARGET_ADDR_FMT "-" TARGET_ADDR_FMT ").",
-				fast_data_area->address, address, address + count);
+				fast_data_area->address, address, address + count * 4);
 		LOG_ERROR("Change work-area-phys or load_image address!");
 		return ERROR_FAIL;
 	}
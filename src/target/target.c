@@ -111,6 +111,8 @@ static int64_t target_timer_next_event_value;
 static LIST_HEAD(target_reset_callback_list);
 static LIST_HEAD(target_trace_callback_list);
 static const int polling_interval = TARGET_DEFAULT_POLLING_INTERVAL;
+/* upper bound in ms for the polling interval of a running target, 0 disables */
+static unsigned int polling_idle_backoff_max;
 static LIST_HEAD(empty_smp_targets);
 
 enum nvp_assert {
@@ -566,6 +568,10 @@ int target_resume(struct target *target, int current, target_addr_t address,
 
 	target_call_event_callbacks(target, TARGET_EVENT_RESUME_START);
 
+	/* poll at full rate right after resume, it may halt soon */
+	target->idle_backoff.times = 0;
+	target->idle_backoff.count = 0;
+
 	/* note that resume *must* be asynchronous. The CPU can halt before
 	 * we poll. The CPU can even halt at the current PC as a result of
 	 * a software breakpoint being inserted by (a bug?) the application.
@@ -1262,6 +1268,21 @@ int target_read_phys_memory(struct target *target,
 	return target->type->read_phys_memory(target, address, size, count, buffer);
 }
 
+/* A memory write may hit the stacked registers of a thread that the RTOS
+ * layer has cached, whichever command or server it comes from. */
+static void target_memory_written(struct target *target)
+{
+	if (target->smp) {
+		struct target_list *head;
+		foreach_smp_target(head, target->smp_targets) {
+			if (head->target->rtos)
+				rtos_stack_cache_invalidate(head->target->rtos);
+		}
+	} else if (target->rtos) {
+		rtos_stack_cache_invalidate(target->rtos);
+	}
+}
+
 int target_write_memory(struct target *target,
 		target_addr_t address, uint32_t size, uint32_t count, const uint8_t *buffer)
 {
@@ -1273,6 +1294,7 @@ int target_write_memory(struct target *target,
 		LOG_ERROR("Target %s doesn't support write_memory", target_name(target));
 		return ERROR_FAIL;
 	}
+	target_memory_written(target);
 	return target->type->write_memory(target, address, size, count, buffer);
 }
 
@@ -1287,6 +1309,7 @@ int target_write_phys_memory(struct target *target,
 		LOG_ERROR("Target %s doesn't support write_phys_memory", target_name(target));
 		return ERROR_FAIL;
 	}
+	target_memory_written(target);
 	return target->type->write_phys_memory(target, address, size, count, buffer);
 }
 
@@ -2360,6 +2383,7 @@ int target_write_buffer(struct target *target, target_addr_t address, uint32_t s
 		return ERROR_FAIL;
 	}
 
+	target_memory_written(target);
 	return target->type->write_buffer(target, address, size, buffer);
 }
 
@@ -2980,8 +3004,17 @@ static int handle_target(void *priv)
 		}
 		target->backoff.count = 0;
 
+		if (target->idle_backoff.times > target->idle_backoff.count) {
+			/* still running at the last poll, skip a few */
+			target->idle_backoff.count++;
+			continue;
+		}
+		target->idle_backoff.count = 0;
+
 		/* only poll target if we've got power and srst isn't asserted */
 		if (!power_dropout && !srst_asserted) {
+			enum target_state prev_state = target->state;
+
 			/* polling may fail silently until the target has been examined */
 			retval = target_poll(target);
 			if (retval != ERROR_OK) {
@@ -3012,6 +3045,17 @@ static int handle_target(void *priv)
 
 			/* Since we succeeded, we reset backoff count */
 			target->backoff.times = 0;
+
+			/* Poll a target that keeps running less and less often, up
+			 * to polling_idle_backoff_max. Any state change, or a resume
+			 * through target_resume(), restores the full polling rate. */
+			if (polling_idle_backoff_max && prev_state == TARGET_RUNNING
+					&& target->state == TARGET_RUNNING) {
+				if ((target->idle_backoff.times * 2 + 2) * polling_interval <= (int)polling_idle_backoff_max)
+					target->idle_backoff.times = target->idle_backoff.times * 2 + 1;
+			} else {
+				target->idle_backoff.times = 0;
+			}
 		}
 	}
 
@@ -3182,6 +3226,22 @@ COMMAND_HANDLER(handle_poll_command)
 	return retval;
 }
 
+COMMAND_HANDLER(handle_poll_backoff_command)
+{
+	if (CMD_ARGC > 1)
+		return ERROR_COMMAND_SYNTAX_ERROR;
+
+	if (CMD_ARGC == 1) {
+		COMMAND_PARSE_NUMBER(uint, CMD_ARGV[0], polling_idle_backoff_max);
+		/* drop any backoff built up under the previous setting */
+		for (struct target *target = all_targets; target; target = target->next)
+			target->idle_backoff.times = 0;
+	}
+
+	command_print(CMD, "running target poll backoff: %u ms", polling_idle_backoff_max);
+	return ERROR_OK;
+}
+
 COMMAND_HANDLER(handle_wait_halt_command)
 {
 	if (CMD_ARGC > 1)
@@ -3700,7 +3760,9 @@ COMMAND_HANDLER(handle_dump_image_command)
 	COMMAND_PARSE_ADDRESS(CMD_ARGV[1], address);
 	COMMAND_PARSE_ADDRESS(CMD_ARGV[2], size);
 
-	uint32_t buf_size = (size > 4096) ? 4096 : size;
+	/* large enough to amortize the per-read adapter overhead, small
+	 * enough to keep data flowing to the file */
+	uint32_t buf_size = (size > 65536) ? 65536 : size;
 	buffer = malloc(buf_size);
 	if (!buffer)
 		return ERROR_FAIL;
@@ -3726,6 +3788,7 @@ COMMAND_HANDLER(handle_dump_image_command)
 
 		size -= this_run_size;
 		address += this_run_size;
+		keep_alive();
 	}
 
 	free(buffer);
@@ -4303,11 +4366,69 @@ static void write_gmon(uint32_t *samples, uint32_t sample_num, const char *filen
 	fclose(f);
 }
 
+static int profile_sample_compare(const void *a, const void *b)
+{
+	uint32_t pc_a = *(const uint32_t *)a;
+	uint32_t pc_b = *(const uint32_t *)b;
+
+	return (pc_a > pc_b) - (pc_a < pc_b);
+}
+
+/* Dump a flat text histogram: one line with the PC and its sample count
+ * per distinct sampled address. Unlike gmon.out there is no bucketing and
+ * no 16-bit count saturation, and the addresses can be symbolized by
+ * addr2line or scripts feeding pprof/flame graph tools.
+ * Note: sorts the samples in place. */
+static int write_profile_text(uint32_t *samples, uint32_t sample_num, const char *filename,
+			bool with_range, uint32_t start_address, uint32_t end_address, uint32_t duration_ms)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f) {
+		LOG_ERROR("Can't open %s: %s", filename, strerror(errno));
+		return ERROR_FAIL;
+	}
+
+	qsort(samples, sample_num, sizeof(*samples), profile_sample_compare);
+
+	fprintf(f, "# %" PRIu32 " samples in %" PRIu32 " ms\n", sample_num, duration_ms);
+	for (uint32_t i = 0; i < sample_num; ) {
+		uint32_t pc = samples[i];
+		uint32_t count = 0;
+		while (i < sample_num && samples[i] == pc) {
+			count++;
+			i++;
+		}
+
+		if (with_range && (pc < start_address || pc >= end_address))
+			continue;
+
+		fprintf(f, "0x%08" PRIx32 " %" PRIu32 "\n", pc, count);
+	}
+
+	int retval = ERROR_OK;
+	if (ferror(f)) {
+		LOG_ERROR("Failed to write %s", filename);
+		retval = ERROR_FAIL;
+	}
+	fclose(f);
+	return retval;
+}
+
 /* profiling samples the CPU PC as quickly as OpenOCD is able,
  * which will be used as a random sampling of PC */
 COMMAND_HANDLER(handle_profile_command)
 {
 	struct target *target = get_current_target(CMD_CTX);
+	bool text_format = false;
+
+	/* optional trailing output format */
+	if (CMD_ARGC == 3 || CMD_ARGC == 5) {
+		if (strcmp(CMD_ARGV[CMD_ARGC - 1], "text") == 0)
+			text_format = true;
+		else if (strcmp(CMD_ARGV[CMD_ARGC - 1], "gmon") != 0)
+			return ERROR_COMMAND_SYNTAX_ERROR;
+		CMD_ARGC--;
+	}
 
 	if ((CMD_ARGC != 2) && (CMD_ARGC != 4))
 		return ERROR_COMMAND_SYNTAX_ERROR;
@@ -4385,8 +4506,17 @@ COMMAND_HANDLER(handle_profile_command)
 		return retval;
 	}
 
-	write_gmon(samples, num_of_samples, CMD_ARGV[1],
-		   with_range, start_address, end_address, target, duration_ms);
+	if (text_format) {
+		retval = write_profile_text(samples, num_of_samples, CMD_ARGV[1],
+				with_range, start_address, end_address, duration_ms);
+		if (retval != ERROR_OK) {
+			free(samples);
+			return retval;
+		}
+	} else {
+		write_gmon(samples, num_of_samples, CMD_ARGV[1],
+			   with_range, start_address, end_address, target, duration_ms);
+	}
 	command_print(CMD, "Wrote %s", CMD_ARGV[1]);
 
 	free(samples);
@@ -4654,6 +4784,197 @@ static int target_jim_write_memory(Jim_Interp *interp, int argc,
 	return e;
 }
 
+/* largest transfer of read_memory_binary, the result is built in memory */
+#define MEMORY_BINARY_MAX	(64 * 1024 * 1024)
+/* bytes per target access, keep_alive() runs in between */
+#define MEMORY_BINARY_CHUNK	(64 * 1024)
+
+static int target_jim_memory_binary_args(Jim_Interp *interp, int argc,
+		Jim_Obj * const *argv, target_addr_t *addr, unsigned int *width, bool *is_phys)
+{
+	/* Arg 1: Memory address. */
+	jim_wide wide_addr;
+	int e = Jim_GetWide(interp, argv[1], &wide_addr);
+	if (e != JIM_OK)
+		return e;
+	*addr = (target_addr_t)wide_addr;
+
+	/* Arg 2: Bit width of one element. */
+	long l;
+	e = Jim_GetLong(interp, argv[2], &l);
+	if (e != JIM_OK)
+		return e;
+
+	switch (l) {
+	case 8:
+	case 16:
+	case 32:
+	case 64:
+		*width = l / 8;
+		break;
+	default:
+		Jim_SetResultString(interp, "invalid width, must be 8, 16, 32 or 64", -1);
+		return JIM_ERR;
+	}
+
+	/* Arg 4: Optional 'phys'. */
+	*is_phys = false;
+	if (argc > 4) {
+		const char *phys = Jim_GetString(argv[4], NULL);
+
+		if (strcmp(phys, "phys")) {
+			Jim_SetResultFormatted(interp, "invalid argument '%s', must be 'phys'", phys);
+			return JIM_ERR;
+		}
+
+		*is_phys = true;
+	}
+
+	return JIM_OK;
+}
+
+static int target_jim_read_memory_binary(Jim_Interp *interp, int argc,
+		Jim_Obj * const *argv)
+{
+	/*
+	 * argv[1] = memory address
+	 * argv[2] = desired element width in bits
+	 * argv[3] = number of elements to read
+	 * argv[4] = optional "phys"
+	 */
+
+	if (argc < 4 || argc > 5) {
+		Jim_WrongNumArgs(interp, 1, argv, "address width count ['phys']");
+		return JIM_ERR;
+	}
+
+	target_addr_t addr;
+	unsigned int width;
+	bool is_phys;
+	int e = target_jim_memory_binary_args(interp, argc, argv, &addr, &width, &is_phys);
+	if (e != JIM_OK)
+		return e;
+
+	/* Arg 3: Number of elements to read. */
+	jim_wide count;
+	e = Jim_GetWide(interp, argv[3], &count);
+	if (e != JIM_OK)
+		return e;
+
+	if (count < 0 || count > MEMORY_BINARY_MAX / width) {
+		Jim_SetResultString(interp, "read_memory_binary: too large read request", -1);
+		return JIM_ERR;
+	}
+
+	const size_t size = count * width;
+
+	if (addr + size < addr) {
+		Jim_SetResultString(interp, "read_memory_binary: addr + count wraps to zero", -1);
+		return JIM_ERR;
+	}
+
+	struct command_context *cmd_ctx = current_command_context(interp);
+	assert(cmd_ctx);
+	struct target *target = get_current_target(cmd_ctx);
+
+	uint8_t *buffer = malloc(size + 1);
+	if (!buffer) {
+		LOG_ERROR("Failed to allocate memory");
+		return JIM_ERR;
+	}
+
+	/* the bytes are returned in target memory order, no element conversion */
+	for (size_t done = 0; done < size; ) {
+		const size_t chunk = MIN(size - done, (size_t)MEMORY_BINARY_CHUNK);
+		int retval;
+
+		if (is_phys)
+			retval = target_read_phys_memory(target, addr + done, width, chunk / width, buffer + done);
+		else
+			retval = target_read_memory(target, addr + done, width, chunk / width, buffer + done);
+
+		if (retval != ERROR_OK) {
+			LOG_DEBUG("read_memory_binary: read at " TARGET_ADDR_FMT " with width=%u and count=%zu failed",
+				addr + done, width * 8, chunk / width);
+			Jim_SetResultString(interp, "read_memory_binary: failed to read memory", -1);
+			free(buffer);
+			return JIM_ERR;
+		}
+
+		done += chunk;
+		keep_alive();
+	}
+
+	Jim_SetResult(interp, Jim_NewStringObj(interp, (const char *)buffer, size));
+	free(buffer);
+
+	return JIM_OK;
+}
+
+static int target_jim_write_memory_binary(Jim_Interp *interp, int argc,
+		Jim_Obj * const *argv)
+{
+	/*
+	 * argv[1] = memory address
+	 * argv[2] = desired element width in bits
+	 * argv[3] = byte string with the data to write
+	 * argv[4] = optional "phys"
+	 */
+
+	if (argc < 4 || argc > 5) {
+		Jim_WrongNumArgs(interp, 1, argv, "address width data ['phys']");
+		return JIM_ERR;
+	}
+
+	target_addr_t addr;
+	unsigned int width;
+	bool is_phys;
+	int e = target_jim_memory_binary_args(interp, argc, argv, &addr, &width, &is_phys);
+	if (e != JIM_OK)
+		return e;
+
+	/* Arg 3: the raw bytes, written as is */
+	int len;
+	const uint8_t *data = (const uint8_t *)Jim_GetString(argv[3], &len);
+	const size_t size = len;
+
+	if (size % width) {
+		Jim_SetResultString(interp, "write_memory_binary: data length is not a multiple of width", -1);
+		return JIM_ERR;
+	}
+
+	if (addr + size < addr) {
+		Jim_SetResultString(interp, "write_memory_binary: addr + len wraps to zero", -1);
+		return JIM_ERR;
+	}
+
+	struct command_context *cmd_ctx = current_command_context(interp);
+	assert(cmd_ctx);
+	struct target *target = get_current_target(cmd_ctx);
+
+	for (size_t done = 0; done < size; ) {
+		const size_t chunk = MIN(size - done, (size_t)MEMORY_BINARY_CHUNK);
+		int retval;
+
+		if (is_phys)
+			retval = target_write_phys_memory(target, addr + done, width, chunk / width, data + done);
+		else
+			retval = target_write_memory(target, addr + done, width, chunk / width, data + done);
+
+		if (retval != ERROR_OK) {
+			LOG_ERROR("write_memory_binary: write at " TARGET_ADDR_FMT " with width=%u and count=%zu failed",
+				addr + done, width * 8, chunk / width);
+			Jim_SetResultString(interp, "write_memory_binary: failed to write memory", -1);
+			return JIM_ERR;
+		}
+
+		done += chunk;
+		keep_alive();
+	}
+
+	return JIM_OK;
+}
+
 /* FIX? should we propagate errors here rather than printing them
  * and continuing?
  */
@@ -5601,6 +5922,20 @@ static const struct command_registration target_instance_command_handlers[] = {
 		.help = "Write Tcl list of 8/16/32/64 bit numbers to target memory",
 		.usage = "address width data ['phys']",
 	},
+	{
+		.name = "read_memory_binary",
+		.mode = COMMAND_EXEC,
+		.jim_handler = target_jim_read_memory_binary,
+		.help = "Read target memory with 8/16/32/64 bit accesses into a byte string",
+		.usage = "address width count ['phys']",
+	},
+	{
+		.name = "write_memory_binary",
+		.mode = COMMAND_EXEC,
+		.jim_handler = target_jim_write_memory_binary,
+		.help = "Write a byte string to target memory with 8/16/32/64 bit accesses",
+		.usage = "address width data ['phys']",
+	},
 	{
 		.name = "eventlist",
 		.handler = handle_target_event_list,
@@ -6522,7 +6857,7 @@ static const struct command_registration target_exec_command_handlers[] = {
 		.name = "profile",
 		.handler = handle_profile_command,
 		.mode = COMMAND_EXEC,
-		.usage = "seconds filename [start end]",
+		.usage = "seconds filename [start end] ['gmon'|'text']",
 		.help = "profiling samples the CPU PC",
 	},
 	/** @todo don't register virt2phys() unless target supports it */
@@ -6548,6 +6883,14 @@ static const struct command_registration target_exec_command_handlers[] = {
 		.help = "poll target state; or reconfigure background polling",
 		.usage = "['on'|'off']",
 	},
+	{
+		.name = "poll_backoff",
+		.handler = handle_poll_backoff_command,
+		.mode = COMMAND_ANY,
+		.help = "set the longest interval in ms between background polls "
+			"of a target that keeps running, 0 polls at the fixed rate",
+		.usage = "[max_ms]",
+	},
 	{
 		.name = "wait_halt",
 		.handler = handle_wait_halt_command,
@@ -6736,6 +7079,20 @@ static const struct command_registration target_exec_command_handlers[] = {
 		.help = "Write Tcl list of 8/16/32/64 bit numbers to target memory",
 		.usage = "address width data ['phys']",
 	},
+	{
+		.name = "read_memory_binary",
+		.mode = COMMAND_EXEC,
+		.jim_handler = target_jim_read_memory_binary,
+		.help = "Read target memory with 8/16/32/64 bit accesses into a byte string",
+		.usage = "address width count ['phys']",
+	},
+	{
+		.name = "write_memory_binary",
+		.mode = COMMAND_EXEC,
+		.jim_handler = target_jim_write_memory_binary,
+		.help = "Write a byte string to target memory with 8/16/32/64 bit accesses",
+		.usage = "address width data ['phys']",
+	},
 	{
 		.name = "reset_nag",
 		.handler = handle_target_reset_nag,
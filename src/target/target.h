@@ -97,6 +97,16 @@ struct gdb_service {
 	/*  element 1 coreid to be displayed at next resume 1 till n 0 means resume
 	 *  all cores core displayed  */
 	int32_t core[2];
+	/* number of gdb connections currently attached to this service */
+	unsigned int connection_count;
+	/* target description and memory map XML, generated for the first
+	 * connection that asks and shared until the last one detaches */
+	char *tdesc;
+	uint32_t tdesc_length;
+	/* register layout the cached target description was built from */
+	uint32_t tdesc_layout;
+	char *memory_map;
+	uint32_t memory_map_length;
 };
 
 /* target back off timer */
@@ -183,6 +193,7 @@ struct target {
 	bool rtos_auto_detect;				/* A flag that indicates that the RTOS has been specified as "auto"
 										 * and must be detected when symbols are offered */
 	struct backoff_timer backoff;
+	struct backoff_timer idle_backoff;	/* polls skipped while the target keeps running */
 	int smp;							/* Unique non-zero number for each SMP group */
 	struct list_head *smp_targets;		/* list all targets in this smp group/cluster
 										 * The head of the list is shared between the
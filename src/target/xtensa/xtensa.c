@@ -115,6 +115,8 @@
 
 /* Store 32-bit Indirect to A(S)+4*IMM8 from A(T) */
 #define XT_INS_S32I(X, S, T, IMM8) _XT_INS_FORMAT_RRI8(X, 0x006002, 0, S, T, IMM8)
+/* Largest word offset encodable in L32I/S32I */
+#define XT_L32I_S32I_MAX_IMM8 0xFF
 /* Store 16-bit to A(S)+2*IMM8 from A(T) */
 #define XT_INS_S16I(X, S, T, IMM8) _XT_INS_FORMAT_RRI8(X, 0x005002, 0, S, T, IMM8)
 /* Store 8-bit to A(S)+IMM8 from A(T) */
@@ -1976,12 +1978,17 @@ int xtensa_read_memory(struct target *target, target_addr_t address, uint32_t si
 				&albuff[i]);
 	} else {
 		xtensa_mark_register_dirty(xtensa, XT_REG_IDX_A4);
+		unsigned int off = 0;
 		for (unsigned int i = 0; adr != addrend_al; i += sizeof(uint32_t), adr += sizeof(uint32_t)) {
-			xtensa_queue_exec_ins(xtensa, XT_INS_L32I(xtensa, XT_REG_A3, XT_REG_A4, 0));
+			if (off > XT_L32I_S32I_MAX_IMM8) {
+				/* Move the base in A3 only when the L32I offset is exhausted */
+				xtensa_queue_dbg_reg_write(xtensa, XDMREG_DDR, adr);
+				xtensa_queue_exec_ins(xtensa, XT_INS_RSR(xtensa, XT_SR_DDR, XT_REG_A3));
+				off = 0;
+			}
+			xtensa_queue_exec_ins(xtensa, XT_INS_L32I(xtensa, XT_REG_A3, XT_REG_A4, off++));
 			xtensa_queue_exec_ins(xtensa, XT_INS_WSR(xtensa, XT_SR_DDR, XT_REG_A4));
 			xtensa_queue_dbg_reg_read(xtensa, XDMREG_DDR, &albuff[i]);
-			xtensa_queue_dbg_reg_write(xtensa, XDMREG_DDR, adr + sizeof(uint32_t));
-			xtensa_queue_exec_ins(xtensa, XT_INS_RSR(xtensa, XT_SR_DDR, XT_REG_A3));
 		}
 	}
 	int res = xtensa_dm_queue_execute(&xtensa->dbg_mod);
@@ -2146,12 +2153,17 @@ int xtensa_write_memory(struct target *target,
 		}
 	} else {
 		xtensa_mark_register_dirty(xtensa, XT_REG_IDX_A4);
+		unsigned int off = 0;
 		for (unsigned int i = 0; adr != addrend_al; i += sizeof(uint32_t), adr += sizeof(uint32_t)) {
+			if (off > XT_L32I_S32I_MAX_IMM8) {
+				/* Move the base in A3 only when the S32I offset is exhausted */
+				xtensa_queue_dbg_reg_write(xtensa, XDMREG_DDR, adr);
+				xtensa_queue_exec_ins(xtensa, XT_INS_RSR(xtensa, XT_SR_DDR, XT_REG_A3));
+				off = 0;
+			}
 			xtensa_queue_dbg_reg_write(xtensa, XDMREG_DDR, buf_get_u32(&albuff[i], 0, 32));
 			xtensa_queue_exec_ins(xtensa, XT_INS_RSR(xtensa, XT_SR_DDR, XT_REG_A4));
-			xtensa_queue_exec_ins(xtensa, XT_INS_S32I(xtensa, XT_REG_A3, XT_REG_A4, 0));
-			xtensa_queue_dbg_reg_write(xtensa, XDMREG_DDR, adr + sizeof(uint32_t));
-			xtensa_queue_exec_ins(xtensa, XT_INS_RSR(xtensa, XT_SR_DDR, XT_REG_A3));
+			xtensa_queue_exec_ins(xtensa, XT_INS_S32I(xtensa, XT_REG_A3, XT_REG_A4, off++));
 		}
 	}
 